@@ -0,0 +1,108 @@
+/**
+  Licensed to the Apache Software Foundation (ASF) under one
+  or more contributor license agreements.  See the NOTICE file
+  distributed with this work for additional information
+  regarding copyright ownership.  The ASF licenses this file
+  to you under the Apache License, Version 2.0 (the
+  "License"); you may not use this file except in compliance
+  with the License.  You may obtain a copy of the License at
+
+      http://www.apache.org/licenses/LICENSE-2.0
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+ */
+
+/*
+ * Resolves the host of every request through HostDB before the transaction goes on, written as a
+ * coroutine with tscpp/api/Coroutine.h. This plugin has to be built as C++20, see Makefile.am.
+ */
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <string>
+
+#include <ts/ts.h>
+#include "tscpp/api/Coroutine.h"
+
+#define PLUGIN_NAME "coroutine_example"
+
+namespace coro = atscppapi::coro;
+
+namespace
+{
+coro::Task
+resolve_host(TSHttpTxn txnp, std::string host)
+{
+  // Runs until the first co_await on the hook's thread, the rest runs from the task's own
+  // continuation once HostDB answers.
+  auto lookup = co_await coro::hostLookup(host);
+
+  if (lookup.edata == nullptr) {
+    TSDebug(PLUGIN_NAME, "%s did not resolve", host.c_str());
+  } else {
+    sockaddr const *addr        = TSHostLookupResultAddrGet(static_cast<TSHostLookupResult>(lookup.edata));
+    char text[INET6_ADDRSTRLEN] = "?";
+
+    if (addr->sa_family == AF_INET) {
+      inet_ntop(AF_INET, &reinterpret_cast<sockaddr_in const *>(addr)->sin_addr, text, sizeof(text));
+    } else if (addr->sa_family == AF_INET6) {
+      inet_ntop(AF_INET6, &reinterpret_cast<sockaddr_in6 const *>(addr)->sin6_addr, text, sizeof(text));
+    }
+    TSDebug(PLUGIN_NAME, "%s resolved to %s", host.c_str(), text);
+  }
+
+  // A brief pause, to show a second await on the same continuation.
+  co_await coro::sleep(0);
+
+  TSHttpTxnReenable(txnp, TS_EVENT_HTTP_CONTINUE);
+}
+
+int
+handle_read_request(TSCont /* contp ATS_UNUSED */, TSEvent /* event ATS_UNUSED */, void *edata)
+{
+  TSHttpTxn txnp = static_cast<TSHttpTxn>(edata);
+  TSMBuffer bufp;
+  TSMLoc hdr_loc;
+  std::string host;
+
+  if (TSHttpTxnClientReqGet(txnp, &bufp, &hdr_loc) == TS_SUCCESS) {
+    int len          = 0;
+    const char *name = TSHttpHdrHostGet(bufp, hdr_loc, &len);
+
+    if (name != nullptr) {
+      host.assign(name, len);
+    }
+    TSHandleMLocRelease(bufp, TS_NULL_MLOC, hdr_loc);
+  }
+
+  if (host.empty()) {
+    TSHttpTxnReenable(txnp, TS_EVENT_HTTP_CONTINUE);
+  } else {
+    // The task reenables the transaction when it is done.
+    resolve_host(txnp, std::move(host));
+  }
+  return 0;
+}
+
+} // namespace
+
+void
+TSPluginInit(int /* argc ATS_UNUSED */, const char * /* argv ATS_UNUSED */[])
+{
+  TSPluginRegistrationInfo info;
+
+  info.plugin_name   = PLUGIN_NAME;
+  info.vendor_name   = "Apache Software Foundation";
+  info.support_email = "dev@trafficserver.apache.org";
+
+  if (TSPluginRegister(&info) != TS_SUCCESS) {
+    TSError("[%s] plugin registration failed", PLUGIN_NAME);
+    return;
+  }
+
+  TSHttpHookAdd(TS_HTTP_READ_REQUEST_HDR_HOOK, TSContCreate(handle_read_request, nullptr));
+}
@@ -1206,6 +1206,29 @@ tsapi TSAction TSHttpSchedule(TSCont contp, TSHttpTxn txnp, TSHRTime timeout);
 tsapi int TSContCall(TSCont contp, TSEvent event, void *edata);
 tsapi TSMutex TSContMutexGet(TSCont contp);
 
+/* --------------------------------------------------------------------------
+   Event pools */
+/**
+    Create a named pool of @a nthreads event threads for plugin work that may block.
+
+    Threads in the pool do nothing but run continuations scheduled with
+    TSContScheduleOnEventPool(), so a slow or blocking plugin can not starve the net or task
+    threads. If @a queue_limit is greater than zero, at most that many events may be pending on the
+    pool at once. Calling this again with the same @a name returns the existing pool. Pools are
+    normally created from TSPluginInit(), a pool created later starts its threads right away.
+
+    @return The pool, or @c nullptr if the pool could not be created or the arguments are invalid.
+ */
+tsapi TSEventPool TSEventPoolCreate(const char *name, int nthreads, int64_t queue_limit);
+
+/**
+    Schedule @a contp on a thread of @a pool after @a timeout milliseconds (0 to run as soon as a
+    thread is free).
+
+    @return The action for the scheduled event, or @c nullptr if the pool queue is full.
+ */
+tsapi TSAction TSContScheduleOnEventPool(TSCont contp, TSHRTime timeout, TSEventPool pool);
+
 /* --------------------------------------------------------------------------
    Plugin lifecycle  hooks */
 tsapi void TSLifecycleHookAdd(TSLifecycleHookID id, TSCont contp);
@@ -2388,6 +2411,14 @@ tsapi TSReturnCode TSHttpTxnCachedRespModifiableGet(TSHttpTxn txnp, TSMBuffer *b
 tsapi TSReturnCode TSHttpTxnCacheLookupStatusSet(TSHttpTxn txnp, int cachelookup);
 tsapi TSReturnCode TSHttpTxnCacheLookupUrlGet(TSHttpTxn txnp, TSMBuffer bufp, TSMLoc obj);
 tsapi TSReturnCode TSHttpTxnCacheLookupUrlSet(TSHttpTxn txnp, TSMBuffer bufp, TSMLoc obj);
+/**
+   Set @a key to the cache key of the lookup URL of @a txnp: the digest and host name the
+   transaction uses for its cache lookup. The digest is computed once per change of the lookup URL
+   and shared with the core, so this is cheaper than TSCacheKeyDigestFromUrlSet().
+
+   @return TS_ERROR if the transaction has no lookup URL yet.
+ */
+tsapi TSReturnCode TSHttpTxnCacheKeyGet(TSHttpTxn txnp, TSCacheKey key);
 tsapi TSReturnCode TSHttpTxnPrivateSessionSet(TSHttpTxn txnp, int private_session);
 tsapi int TSHttpTxnBackgroundFillStarted(TSHttpTxn txnp);
 tsapi int TSHttpTxnIsWebsocket(TSHttpTxn txnp);
@@ -101,11 +101,26 @@ public:
     ink_freelist_init(&fl, name, element_size, chunk_size, alignment);
   }
 
-  /** Re-initialize the parameters of the allocator. */
+  /** Re-initialize the parameters of the allocator.
+      If @a hugepages is set the chunks are backed by huge pages, transparent ones if no explicit
+      huge pages are available, regardless of the global huge page setting.
+  */
   void
-  re_init(const char *name, unsigned int element_size, unsigned int chunk_size, unsigned int alignment, int advice)
+  re_init(const char *name, unsigned int element_size, unsigned int chunk_size, unsigned int alignment, int advice,
+          bool hugepages = false)
+  {
+    if (hugepages) {
+      ink_freelist_hugepage_init(&this->fl, name, element_size, chunk_size, alignment, advice);
+    } else {
+      ink_freelist_madvise_init(&this->fl, name, element_size, chunk_size, alignment, advice);
+    }
+  }
+
+  /** The underlying free list, for reporting. */
+  const InkFreeList *
+  freelist() const
   {
-    ink_freelist_madvise_init(&this->fl, name, element_size, chunk_size, alignment, advice);
+    return this->fl;
   }
 
 protected:
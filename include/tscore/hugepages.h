@@ -27,3 +27,4 @@ bool ats_hugepage_enabled();
 void ats_hugepage_init(int);
 void *ats_alloc_hugepage(size_t);
 bool ats_free_hugepage(void *, size_t);
+void *ats_alloc_transparent_hugepage(size_t);
@@ -170,6 +170,9 @@ struct _InkFreeList {
   uint32_t type_size, chunk_size, used, allocated, alignment;
   uint32_t allocated_base, used_base;
   int advice;
+  int hugepages;                  /* back chunks with huge pages even if not enabled globally */
+  uint32_t hugepage_allocated;    /* # of items in chunks backed by explicit huge pages */
+  uint32_t transparent_allocated; /* # of items in chunks advised for transparent huge pages */
 };
 
 typedef struct ink_freelist_ops InkFreeListOps;
@@ -187,6 +190,8 @@ InkFreeList *ink_freelist_create(const char *name, uint32_t type_size, uint32_t
 inkcoreapi void ink_freelist_init(InkFreeList **fl, const char *name, uint32_t type_size, uint32_t chunk_size, uint32_t alignment);
 inkcoreapi void ink_freelist_madvise_init(InkFreeList **fl, const char *name, uint32_t type_size, uint32_t chunk_size,
                                           uint32_t alignment, int advice);
+inkcoreapi void ink_freelist_hugepage_init(InkFreeList **fl, const char *name, uint32_t type_size, uint32_t chunk_size,
+                                           uint32_t alignment, int advice);
 inkcoreapi void *ink_freelist_new(InkFreeList *f);
 inkcoreapi void ink_freelist_free(InkFreeList *f, void *item);
 inkcoreapi void ink_freelist_free_bulk(InkFreeList *f, void *head, void *tail, size_t num_item);
@@ -0,0 +1,351 @@
+/**
+  Licensed to the Apache Software Foundation (ASF) under one
+  or more contributor license agreements.  See the NOTICE file
+  distributed with this work for additional information
+  regarding copyright ownership.  The ASF licenses this file
+  to you under the Apache License, Version 2.0 (the
+  "License"); you may not use this file except in compliance
+  with the License.  You may obtain a copy of the License at
+
+      http://www.apache.org/licenses/LICENSE-2.0
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+ */
+
+/**
+ * @file Coroutine.h
+ * @brief C++20 coroutine adapter for TS API continuations.
+ *
+ * A coroutine returning @c atscppapi::coro::Task owns exactly one TSCont (created with its own
+ * mutex) for its whole lifetime. Every @c co_await arms that continuation for a single event and
+ * suspends; the event handler resumes the coroutine in place on the thread that delivered the
+ * event. No heap allocation is done per await, so a multi-step plugin operation costs one
+ * coroutine frame and one continuation instead of a continuation per step.
+ *
+ * Example:
+ * @code
+ *   atscppapi::coro::Task
+ *   fetch_from_cache(TSCacheKey key)
+ *   {
+ *     auto open = co_await atscppapi::coro::cacheRead(key);
+ *     if (open.event != TS_EVENT_CACHE_OPEN_READ) {
+ *       co_return;
+ *     }
+ *     auto vc     = static_cast<TSVConn>(open.edata);
+ *     auto buffer = TSIOBufferCreate();
+ *     auto io     = co_await atscppapi::coro::vioRead(vc, buffer, INT64_MAX);
+ *     while (io.event == TS_EVENT_VCONN_READ_READY) {
+ *       // ... consume data ...
+ *       io = co_await atscppapi::coro::vioNext(static_cast<TSVIO>(io.edata));
+ *     }
+ *     TSVConnClose(vc);
+ *     TSIOBufferDestroy(buffer);
+ *   }
+ * @endcode
+ *
+ * Because one continuation serves every await, each awaiter says which events complete it: the
+ * events its operation can send and, for VIO operations, the TSVIO they must carry. Anything else
+ * reaching the continuation is stale, for instance a READ_READY from a VIO the coroutine is no
+ * longer waiting on, and is dropped.
+ *
+ * The first segment of the coroutine (up to the first suspension) runs on the caller's stack.
+ * Later segments run from the continuation handler, with the continuation mutex held, so the
+ * usual TS API rules about which calls are permitted from a continuation apply.
+ *
+ * This header is only active when compiled as C++20 or later with coroutine support; core is
+ * still built as C++17 and ignores it. example/plugins/cpp-api/coroutine is a plugin built that way.
+ */
+
+#pragma once
+
+#if defined(__cpp_impl_coroutine) && __has_include(<coroutine>)
+
+#include <coroutine>
+#include <exception>
+#include <string_view>
+#include <ts/ts.h>
+
+namespace atscppapi
+{
+namespace coro
+{
+/// The event (and its data) that resumed a suspended coroutine.
+struct Event {
+  TSEvent event = TS_EVENT_NONE;
+  void *edata   = nullptr;
+};
+
+/// Per-await state shared between an awaiter and the owning promise.
+struct AwaitSlot {
+  Event result;
+  bool done = false;
+  /// Events that complete the await, any event if @c nullptr.
+  bool (*accepts)(TSEvent) = nullptr;
+  /// Data the event must carry (the TSVIO of a VIO operation), any data if @c nullptr.
+  void *tag = nullptr;
+
+  bool
+  matches(TSEvent event, void *edata) const
+  {
+    return (accepts == nullptr || accepts(event)) && (tag == nullptr || tag == edata);
+  }
+};
+
+/// Events a VConnection sends for one of its VIOs, all of them carry the TSVIO.
+inline bool
+is_vio_event(TSEvent event)
+{
+  switch (event) {
+  case TS_EVENT_VCONN_READ_READY:
+  case TS_EVENT_VCONN_WRITE_READY:
+  case TS_EVENT_VCONN_READ_COMPLETE:
+  case TS_EVENT_VCONN_WRITE_COMPLETE:
+  case TS_EVENT_VCONN_EOS:
+  case TS_EVENT_VCONN_INACTIVITY_TIMEOUT:
+  case TS_EVENT_VCONN_ACTIVE_TIMEOUT:
+  case TS_EVENT_ERROR:
+    return true;
+  default:
+    return false;
+  }
+}
+
+/**
+ * @brief Fire-and-forget coroutine type.
+ *
+ * The coroutine starts running immediately and its frame is released when it finishes. The
+ * continuation is bound to the EThread that created the task, so timers scheduled through
+ * @c sleep() come back to the same thread.
+ */
+class Task
+{
+public:
+  class promise_type
+  {
+  public:
+    promise_type() : _cont(TSContCreate(&promise_type::_eventFunc, TSMutexCreate())) { TSContDataSet(_cont, this); }
+
+    ~promise_type() { TSContDestroy(_cont); }
+
+    promise_type(const promise_type &) = delete;
+    promise_type &operator=(const promise_type &) = delete;
+
+    Task
+    get_return_object() noexcept
+    {
+      return {};
+    }
+
+    std::suspend_never
+    initial_suspend() noexcept
+    {
+      return {};
+    }
+
+    std::suspend_never
+    final_suspend() noexcept
+    {
+      return {};
+    }
+
+    void
+    return_void() noexcept
+    {
+    }
+
+    void
+    unhandled_exception() noexcept
+    {
+      std::terminate();
+    }
+
+    TSCont
+    cont() const
+    {
+      return _cont;
+    }
+
+    /// Arm the continuation so the next matching event completes @a slot. Returns @c true if the
+    /// coroutine should suspend, @c false if @a start delivered the event synchronously.
+    ///
+    /// @a start returns the data the event must carry, or @c nullptr if the event alone identifies
+    /// it. That is only known once @a start returns, an event delivered from inside @a start is
+    /// matched on its type.
+    template <typename StartFunc>
+    bool
+    arm(AwaitSlot *slot, std::coroutine_handle<> handle, StartFunc &&start)
+    {
+      _slot     = slot;
+      _handle   = handle;
+      _starting = true;
+      void *tag = start(_cont);
+      _starting = false;
+      if (!slot->done && slot->tag == nullptr) {
+        slot->tag = tag;
+      }
+      return !slot->done;
+    }
+
+  private:
+    static int
+    _eventFunc(TSCont cont, TSEvent event, void *edata)
+    {
+      auto *self = static_cast<promise_type *>(TSContDataGet(cont));
+      auto *slot = self->_slot;
+
+      if (slot == nullptr || !slot->matches(event, edata)) {
+        // Nobody is waiting for this, e.g. a late VIO event after the coroutine moved on.
+        return 0;
+      }
+      self->_slot        = nullptr;
+      slot->result.event = event;
+      slot->result.edata = edata;
+      slot->done         = true;
+      if (!self->_starting) {
+        self->_handle.resume();
+      }
+      return 0;
+    }
+
+    TSCont _cont;
+    AwaitSlot *_slot = nullptr;
+    std::coroutine_handle<> _handle;
+    bool _starting = false;
+  };
+};
+
+/**
+ * @brief Awaitable that arms the coroutine's continuation and waits for one event.
+ *
+ * @a StartFunc is invoked with the coroutine's TSCont and must start the asynchronous operation
+ * that will eventually call that continuation back. It may call back synchronously. It returns the
+ * data the event will carry if that identifies the operation (a TSVIO), @c nullptr otherwise.
+ * Only events for which @a accepts returns @c true complete the await.
+ */
+template <typename StartFunc> class EventAwaiter
+{
+public:
+  EventAwaiter(bool (*accepts)(TSEvent), StartFunc start) : _start(start) { _slot.accepts = accepts; }
+
+  bool
+  await_ready() const noexcept
+  {
+    return false;
+  }
+
+  template <typename Promise>
+  bool
+  await_suspend(std::coroutine_handle<Promise> handle)
+  {
+    return handle.promise().arm(&_slot, handle, _start);
+  }
+
+  Event
+  await_resume() const noexcept
+  {
+    return _slot.result;
+  }
+
+private:
+  StartFunc _start;
+  AwaitSlot _slot;
+};
+
+template <typename StartFunc>
+inline EventAwaiter<StartFunc>
+await_event(bool (*accepts)(TSEvent), StartFunc start)
+{
+  return EventAwaiter<StartFunc>(accepts, start);
+}
+
+/// Resume after @a timeout milliseconds on the thread that owns the task (0 yields).
+inline auto
+sleep(TSHRTime timeout)
+{
+  return await_event([](TSEvent event) { return event == TS_EVENT_TIMEOUT || event == TS_EVENT_IMMEDIATE; },
+                     [timeout](TSCont cont) -> void * {
+                       TSContSchedule(cont, timeout);
+                       return nullptr;
+                     });
+}
+
+/// Resume after @a timeout milliseconds on a thread from @a tp.
+inline auto
+sleep(TSHRTime timeout, TSThreadPool tp)
+{
+  return await_event([](TSEvent event) { return event == TS_EVENT_TIMEOUT || event == TS_EVENT_IMMEDIATE; },
+                     [timeout, tp](TSCont cont) -> void * {
+                       TSContScheduleOnPool(cont, timeout, tp);
+                       return nullptr;
+                     });
+}
+
+/// Open a cache object for read. Resumes with TS_EVENT_CACHE_OPEN_READ (edata is the TSVConn)
+/// or TS_EVENT_CACHE_OPEN_READ_FAILED.
+inline auto
+cacheRead(TSCacheKey key)
+{
+  return await_event([](TSEvent event) { return event == TS_EVENT_CACHE_OPEN_READ || event == TS_EVENT_CACHE_OPEN_READ_FAILED; },
+                     [key](TSCont cont) -> void * {
+                       TSCacheRead(cont, key);
+                       return nullptr;
+                     });
+}
+
+/// Open a cache object for write. Resumes with TS_EVENT_CACHE_OPEN_WRITE (edata is the TSVConn)
+/// or TS_EVENT_CACHE_OPEN_WRITE_FAILED.
+inline auto
+cacheWrite(TSCacheKey key)
+{
+  return await_event(
+    [](TSEvent event) { return event == TS_EVENT_CACHE_OPEN_WRITE || event == TS_EVENT_CACHE_OPEN_WRITE_FAILED; },
+    [key](TSCont cont) -> void * {
+      TSCacheWrite(cont, key);
+      return nullptr;
+    });
+}
+
+/// Resolve @a host through HostDB. Resumes with TS_EVENT_HOST_LOOKUP, edata is the
+/// TSHostLookupResult (nullptr on failure).
+inline auto
+hostLookup(std::string_view host)
+{
+  return await_event([](TSEvent event) { return event == TS_EVENT_HOST_LOOKUP; },
+                     [host](TSCont cont) -> void * {
+                       TSHostLookup(cont, host.data(), host.size());
+                       return nullptr;
+                     });
+}
+
+/// Start a read on @a vc and wait for its first event. edata of the result is the TSVIO.
+inline auto
+vioRead(TSVConn vc, TSIOBuffer buffer, int64_t nbytes)
+{
+  return await_event(is_vio_event, [=](TSCont cont) -> void * { return TSVConnRead(vc, cont, buffer, nbytes); });
+}
+
+/// Start a write on @a vc and wait for its first event. edata of the result is the TSVIO.
+inline auto
+vioWrite(TSVConn vc, TSIOBufferReader reader, int64_t nbytes)
+{
+  return await_event(is_vio_event, [=](TSCont cont) -> void * { return TSVConnWrite(vc, cont, reader, nbytes); });
+}
+
+/// Reenable @a vio and wait for its next event.
+inline auto
+vioNext(TSVIO vio)
+{
+  return await_event(is_vio_event, [vio](TSCont) -> void * {
+    TSVIOReenable(vio);
+    return vio;
+  });
+}
+
+} // namespace coro
+} // namespace atscppapi
+
+#endif
@@ -77,6 +77,7 @@ int cache_config_force_sector_size             = 0;
 int cache_config_target_fragment_size          = DEFAULT_TARGET_FRAGMENT_SIZE;
 int cache_config_agg_write_backlog             = AGG_SIZE * 2;
 int cache_config_enable_checksum               = 0;
+int cache_config_mmap_fragments                = 0;
 int cache_config_alt_rewrite_max_size          = 4096;
 int cache_config_read_while_writer             = 0;
 int cache_config_mutex_retry_delay             = 2;
@@ -306,6 +307,8 @@ CacheVC::do_io_read(Continuation *c, int64_t nbytes, MIOBuffer *abuf)
   vio.ndone     = 0;
   vio.nbytes    = nbytes;
   vio.vc_server = this;
+
+  f.map_fragments = f.map_allowed && cache_config_mmap_fragments && vol->disk->map_fd >= 0;
 #ifdef DEBUG
   ink_assert(!c || c->mutex->thread_holding);
 #endif
@@ -325,6 +328,8 @@ CacheVC::do_io_pread(Continuation *c, int64_t nbytes, MIOBuffer *abuf, int64_t o
   vio.nbytes    = nbytes;
   vio.vc_server = this;
   seek_to       = offset;
+
+  f.map_fragments = f.map_allowed && cache_config_mmap_fragments && vol->disk->map_fd >= 0;
 #ifdef DEBUG
   ink_assert(c->mutex->thread_holding);
 #endif
@@ -668,6 +673,13 @@ CacheProcessor::start_internal(int flags)
           gdisks[gndisks]->hash_base_string = ats_strdup(sd->hash_base_string);
         }
 
+        if (cache_config_mmap_fragments && !check) {
+          // Mapped fragments go through the page cache, they need a descriptor without O_DIRECT.
+          if ((gdisks[gndisks]->map_fd = open(path, O_RDONLY)) < 0) {
+            Warning("unable to open '%s' for mapping fragments: %s", path, strerror(errno));
+          }
+        }
+
         if (sector_size < cache_config_force_sector_size) {
           sector_size = cache_config_force_sector_size;
         }
@@ -1756,6 +1768,7 @@ Vol::dir_init_done(int /* event ATS_UNUSED */, void * /* data ATS_UNUSED */)
     int vol_no = gnvol++;
     ink_assert(!gvol[vol_no]);
     gvol[vol_no] = this;
+    publish_write_mark();
     SET_HANDLER(&Vol::aggWrite);
     if (fd == -1) {
       cache->vol_initialized(false);
@@ -2267,6 +2280,12 @@ CacheVC::handleReadDone(int event, Event *e)
     ink_assert(vol->mutex->nthread_holding < 1000);
     ink_assert(doc->magic == DOC_MAGIC);
 
+    if (f.header_only) {
+      // The body was not read, there is nothing to upgrade, verify or put in the RAM cache.
+      f.not_from_ram_cache = 1;
+      goto Ldone;
+    }
+
     /* We've read the raw data from disk, time to deserialize it. We have to account for a variety of formats that
        may be present.
 
@@ -2389,6 +2408,8 @@ CacheVC::handleRead(int /* event ATS_UNUSED */, Event * /* e ATS_UNUSED */)
   cancel_trigger();
 
   f.doc_from_ram_cache = false;
+  f.header_only        = false;
+  map_buf.clear();
 
   // check ram cache
   ink_assert(vol->mutex->thread_holding == this_ethread());
@@ -2419,6 +2440,12 @@ CacheVC::handleRead(int /* event ATS_UNUSED */, Event * /* e ATS_UNUSED */)
 
   io.aiocb.aio_fildes = vol->fd;
   io.aiocb.aio_offset = vol->vol_offset(&dir);
+  if (f.map_fragments && read_key == &key && io.aiocb.aio_nbytes >= MAP_FRAGMENT_MIN_SIZE &&
+      !vol->within_write_window(&dir, vol->data_blocks * MAP_FRAGMENT_WRITE_WINDOW_PERCENT / 100)) {
+    // Just the Doc header, map_fragment() maps the rest.
+    io.aiocb.aio_nbytes = MAP_FRAGMENT_PROBE_SIZE;
+    f.header_only       = true;
+  }
   if ((off_t)(io.aiocb.aio_offset + io.aiocb.aio_nbytes) > (off_t)(vol->skip + vol->len)) {
     io.aiocb.aio_nbytes = vol->skip + vol->len - io.aiocb.aio_offset;
   }
@@ -3139,6 +3166,9 @@ register_cache_stats(RecRawStatBlock *rsb, const char *prefix)
   REG_INT("hdr_marshal_bytes", cache_hdr_marshal_bytes_stat);
   REG_INT("gc_bytes_evacuated", cache_gc_bytes_evacuated_stat);
   REG_INT("gc_frags_evacuated", cache_gc_frags_evacuated_stat);
+  REG_INT("mapped_frags", cache_mapped_frags_stat);
+  REG_INT("mapped_bytes", cache_mapped_bytes_stat);
+  REG_INT("mapped_frags_copied", cache_mapped_frags_copied_stat);
   REG_INT("wrap_count", cache_directory_wrap_stat);
   REG_INT("sync.count", cache_directory_sync_count_stat);
   REG_INT("sync.bytes", cache_directory_sync_bytes_stat);
@@ -3237,6 +3267,13 @@ ink_cache_init(ts::ModuleVersion v)
   REC_EstablishStaticConfigInt32(cache_config_alt_rewrite_max_size, "proxy.config.cache.alt_rewrite_max_size");
   Debug("cache_init", "proxy.config.cache.alt_rewrite_max_size = %d", cache_config_alt_rewrite_max_size);
 
+  REC_ReadConfigInt32(cache_config_mmap_fragments, "proxy.config.cache.mmap_fragments");
+  if (cache_config_mmap_fragments && cache_config_enable_checksum) {
+    Warning("proxy.config.cache.mmap_fragments has no effect when proxy.config.cache.enable_checksum is set");
+    cache_config_mmap_fragments = 0;
+  }
+  Debug("cache_init", "proxy.config.cache.mmap_fragments = %d", cache_config_mmap_fragments);
+
   REC_EstablishStaticConfigInt32(cache_config_read_while_writer, "proxy.config.cache.enable_read_while_writer");
   cache_config_read_while_writer = validate_rww(cache_config_read_while_writer);
   REC_RegisterConfigUpdateFunc("proxy.config.cache.enable_read_while_writer", update_cache_config, nullptr);
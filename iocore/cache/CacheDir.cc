@@ -970,6 +970,7 @@ sync_cache_dir_on_shutdown()
 
       // set write limit
       d->header->agg_pos = d->header->write_pos + d->agg_buf_pos;
+      d->publish_write_mark();
 
       int r = pwrite(d->fd, d->agg_buffer, d->agg_buf_pos, d->header->write_pos);
       if (r != d->agg_buf_pos) {
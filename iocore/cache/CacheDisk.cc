@@ -120,6 +120,9 @@ CacheDisk::~CacheDisk()
     ats_free(disk_vols);
     free(header);
   }
+  if (map_fd >= 0) {
+    close(map_fd);
+  }
   if (free_blocks) {
     DiskVolBlockQueue *q = nullptr;
     while ((q = (free_blocks->dpb_queue.pop()))) {
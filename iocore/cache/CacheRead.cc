@@ -549,6 +549,135 @@ CacheVC::openReadClose(int event, Event * /* e ATS_UNUSED */)
   return free_CacheVC(this);
 }
 
+/*
+  Maps fragments for CacheVC::map_fragment() on a task thread. The pages are
+  read in there, so a net thread sending them never waits for the disk. The
+  span is written with O_DIRECT, which bypasses the page cache, so the mapping
+  is only used if it starts with the Doc header that was read from the disk.
+*/
+struct CacheFragmentMapper : public Continuation {
+  int fd;
+  off_t offset;
+  int64_t len;
+  IOBufferMapGuard guard;
+  Ptr<IOBufferData> probe;
+  int64_t probe_len;
+  CacheVC *vc;
+
+  int
+  mapEvent(int /* event ATS_UNUSED */, Event * /* e ATS_UNUSED */)
+  {
+    Ptr<IOBufferData> data;
+
+    for (int attempt = 0; attempt < 2 && !data; ++attempt) {
+      data = new_mmap_IOBufferData(fd, offset, len, guard);
+      if (!data) {
+        Debug("cache_read", "unable to map fragment of %" PRId64 " bytes at %" PRId64 ": %s", len, (int64_t)offset, strerror(errno));
+        break;
+      }
+      if (memcmp(data->data(), probe->data(), probe_len) != 0) {
+        // The page cache still has what was there before the last write, drop it and try once more.
+        data.clear();
+        posix_fadvise(fd, offset, len, POSIX_FADV_DONTNEED);
+      }
+    }
+    if (data && !guard.safe()) {
+      data.clear(); // the writer got close while the pages were read in
+    }
+
+    vc->map_buf     = data;
+    AIOCallback *op = &vc->io;
+    delete this;
+    if (op->thread == AIO_CALLBACK_THREAD_ANY) {
+      eventProcessor.schedule_imm_signal(op);
+    } else {
+      op->thread->schedule_imm_signal(op);
+    }
+    return EVENT_DONE;
+  }
+
+  CacheFragmentMapper(CacheVC *avc, int afd, off_t aoffset, int64_t alen, const IOBufferMapGuard &aguard)
+    : Continuation(new_ProxyMutex()),
+      fd(afd),
+      offset(aoffset),
+      len(alen),
+      guard(aguard),
+      probe(avc->buf),
+      probe_len(avc->io.aiocb.aio_nbytes),
+      vc(avc)
+  {
+    SET_HANDLER(&CacheFragmentMapper::mapEvent);
+  }
+};
+
+/*
+  After a header_only read, have the whole fragment mapped on a task thread
+  instead of reading the rest of it. The io is in progress until the mapper
+  is done, openReadMapDone() then goes back to openReadReadDone(), which
+  hands out the mapping or reads the fragment after all. Called with the
+  vol lock held. Returns false if the fragment has to be read now.
+*/
+bool
+CacheVC::map_fragment()
+{
+  Doc *doc = reinterpret_cast<Doc *>(buf->data());
+
+  if (doc->doc_type == CACHE_FRAG_TYPE_HTTP_V23 ||
+      (doc->doc_type == CACHE_FRAG_TYPE_HTTP && ts::VersionNumber(doc->v_major, doc->v_minor) > CACHE_DB_VERSION) || doc->hlen ||
+      doc->len <= io.aiocb.aio_nbytes) {
+    return false;
+  }
+
+  // Bytes handed out from the mapping are copied once the writer of the stripe gets this close to them.
+  IOBufferMapGuard guard;
+  guard.position = &vol->write_mark;
+  guard.limit    = vol->overwrite_mark(&dir);
+  guard.margin   = vol->data_blocks * MAP_FRAGMENT_WRITE_WINDOW_PERCENT / 100 * CACHE_BLOCK_SIZE;
+  if (!guard.safe()) {
+    return false;
+  }
+
+  CacheFragmentMapper *mapper = new CacheFragmentMapper(this, vol->disk->map_fd, io.aiocb.aio_offset, doc->len, guard);
+  io.aiocb.aio_fildes         = vol->disk->map_fd;
+  io.mutex                    = io.action.mutex;
+  PUSH_HANDLER(&CacheVC::openReadMapDone);
+  eventProcessor.schedule_imm(mapper, ET_TASK);
+  return true;
+}
+
+int
+CacheVC::openReadMapDone(int event, Event * /* e ATS_UNUSED */)
+{
+  cancel_trigger();
+  if (event == EVENT_IMMEDIATE) {
+    return EVENT_CONT;
+  }
+  if (!map_buf) {
+    f.map_fragments = false;
+  }
+  POP_HANDLER;
+  return handleEvent(AIO_EVENT_DONE, nullptr);
+}
+
+/*
+  Swap the mapped fragment in buf for a copy, for when the writer of the
+  stripe is about to overwrite it. Returns false if it already did.
+*/
+bool
+CacheVC::copy_mapped_fragment()
+{
+  int64_t len          = reinterpret_cast<Doc *>(buf->data())->len;
+  Ptr<IOBufferData> cp = make_ptr(new_IOBufferData(iobuffer_size_to_index(len, MAX_BUFFER_SIZE_INDEX), MEMALIGNED));
+
+  memcpy(cp->data(), buf->data(), len);
+  if (!buf->_map_guard.intact()) {
+    return false;
+  }
+  CACHE_INCREMENT_DYN_STAT(cache_mapped_frags_copied_stat);
+  buf = cp;
+  return true;
+}
+
 int
 CacheVC::openReadReadDone(int event, Event *e)
 {
@@ -582,6 +711,25 @@ CacheVC::openReadReadDone(int event, Event *e)
         goto Lerror;
       }
       if (doc->key == key) {
+        if (f.header_only) {
+          if (map_buf) {
+            CACHE_INCREMENT_DYN_STAT(cache_mapped_frags_stat);
+            CACHE_SUM_DYN_STAT(cache_mapped_bytes_stat, doc->data_len());
+            buf = map_buf;
+            map_buf.clear();
+            doc = (Doc *)buf->data();
+            goto LreadMain;
+          }
+          if (f.map_fragments && map_fragment()) {
+            return EVENT_CONT;
+          }
+          f.map_fragments = false;
+          int ret         = do_read_call(&key);
+          if (ret == EVENT_RETURN) {
+            goto Lcallreturn;
+          }
+          return EVENT_CONT;
+        }
         goto LreadMain;
       }
     }
@@ -735,6 +883,11 @@ CacheVC::openReadMain(int /* event ATS_UNUSED */, Event * /* e ATS_UNUSED */)
   if (bytes > vio.ntodo()) {
     bytes = vio.ntodo();
   }
+  if (buf->_mem_type == MMAPPED && !buf->_map_guard.safe() && !copy_mapped_fragment()) {
+    char tmpstring[CRYPTO_HEX_SIZE];
+    Warning("Mapped fragment of %s overwritten while being read", first_key.toHexStr(tmpstring));
+    return calluser(VC_EVENT_ERROR);
+  }
   b           = new_IOBufferBlock(buf, bytes, doc_pos);
   b->_buf_end = b->_end;
   vio.buffer.writer()->append_block(b);
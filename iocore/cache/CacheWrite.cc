@@ -956,6 +956,7 @@ Vol::agg_wrap()
 
   header->cycle++;
   header->agg_pos = header->write_pos;
+  publish_write_mark();
   dir_lookaside_cleanup(this);
   dir_clean_vol(this);
   {
@@ -1068,6 +1069,7 @@ Lagain:
 
   // set write limit
   header->agg_pos = header->write_pos + agg_buf_pos;
+  publish_write_mark();
 
   io.aiocb.aio_fildes = fd;
   io.aiocb.aio_offset = header->write_pos;
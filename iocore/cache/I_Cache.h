@@ -205,6 +205,15 @@ struct CacheVConnection : public VConnection {
     return -1;
   }
 
+  /** Allow later fragments to be handed out as memory mapped from the span, see
+      proxy.config.cache.mmap_fragments. Only for readers that write the bytes
+      straight to a plain socket, call before @c do_io_read.
+  */
+  virtual void
+  allow_mapped_fragments()
+  {
+  }
+
   /** Test if the VC can support pread.
       @return @c true if @c do_io_pread will work, @c false if not.
   */
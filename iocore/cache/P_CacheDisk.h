@@ -89,6 +89,7 @@ struct CacheDisk : public Continuation {
   off_t num_usable_blocks = 0;
   int hw_sector_size      = 0;
   int fd                  = -1;
+  int map_fd              = -1; // opened without O_DIRECT, see proxy.config.cache.mmap_fragments
   off_t free_space        = 0;
   off_t wasted_space      = 0;
   DiskVol **disk_vols     = nullptr;
@@ -41,6 +41,11 @@ struct EvacuationBlock;
 
 #define INTEGRAL_FRAGS 4
 
+// Mapping fragments instead of reading them, see CacheVC::map_fragment().
+#define MAP_FRAGMENT_MIN_SIZE (64 * 1024)        // smaller fragments are simply read
+#define MAP_FRAGMENT_PROBE_SIZE STORE_BLOCK_SIZE // read to get the Doc header
+#define MAP_FRAGMENT_WRITE_WINDOW_PERCENT 10     // not mapped this close in front of the write cursor
+
 #ifdef CACHE_INSPECTOR_PAGES
 #ifdef DEBUG
 #define CACHE_STAT_PAGES
@@ -137,6 +142,9 @@ enum {
   cache_read_busy_failure_stat,
   cache_gc_bytes_evacuated_stat,
   cache_gc_frags_evacuated_stat,
+  cache_mapped_frags_stat,
+  cache_mapped_bytes_stat,
+  cache_mapped_frags_copied_stat,
   cache_write_bytes_stat,
   cache_hdr_vector_marshal_stat,
   cache_hdr_marshal_stat,
@@ -213,6 +221,7 @@ extern int cache_config_max_doc_size;
 extern int cache_config_min_average_object_size;
 extern int cache_config_agg_write_backlog;
 extern int cache_config_enable_checksum;
+extern int cache_config_mmap_fragments;
 extern int cache_config_alt_rewrite_max_size;
 extern int cache_config_read_while_writer;
 extern int cache_config_agg_write_backlog;
@@ -283,6 +292,13 @@ struct CacheVC : public CacheVConnection {
     return -1;
   }
 
+  void
+  allow_mapped_fragments() override
+  {
+    ink_assert(vio.op == VIO::READ);
+    f.map_allowed = true;
+  }
+
   int
   get_volume_number() const override
   {
@@ -309,6 +325,8 @@ struct CacheVC : public CacheVConnection {
   int handleReadDone(int event, Event *e);
   int handleRead(int event, Event *e);
   int do_read_call(CacheKey *akey);
+  bool map_fragment();
+  bool copy_mapped_fragment();
   int handleWrite(int event, Event *e);
   int handleWriteLock(int event, Event *e);
   int do_write_call();
@@ -319,6 +337,7 @@ struct CacheVC : public CacheVConnection {
   int openReadClose(int event, Event *e);
   int openReadReadDone(int event, Event *e);
   int openReadMain(int event, Event *e);
+  int openReadMapDone(int event, Event *e);
   int openReadStartEarliest(int event, Event *e);
   int openReadVecWrite(int event, Event *e);
   int openReadStartHead(int event, Event *e);
@@ -420,6 +439,7 @@ struct CacheVC : public CacheVConnection {
   Ptr<IOBufferData> first_buf;
   Ptr<IOBufferBlock> blocks; // data available to write
   Ptr<IOBufferBlock> writer_buf;
+  Ptr<IOBufferData> map_buf; // fragment mapped by CacheFragmentMapper
 
   OpenDirEntry *od;
   AIOCallbackInternal io;
@@ -498,6 +518,9 @@ struct CacheVC : public CacheVConnection {
       unsigned int hit_evacuate : 1;
       unsigned int compressed_in_ram : 1; // compressed state in ram cache
       unsigned int allow_empty_doc : 1;   // used for cache empty http document
+      unsigned int map_fragments : 1;     // map later fragments from the span instead of reading them
+      unsigned int header_only : 1;       // only the Doc header of the fragment was read
+      unsigned int map_allowed : 1;       // the reader takes mapped fragments, see allow_mapped_fragments()
     } f;
   };
   // BTF optimization used to skip reading stuff in cache partition that doesn't contain any
@@ -601,6 +624,7 @@ free_CacheVC(CacheVC *cont)
   cont->first_buf.clear();
   cont->blocks.clear();
   cont->writer_buf.clear();
+  cont->map_buf.clear();
   cont->alternate_index = CACHE_ALT_INDEX_DEFAULT;
   if (cont->scan_vol_map) {
     ats_free(cont->scan_vol_map);
@@ -995,6 +1019,8 @@ struct Cache {
                      int host_len = 0);
   static void generate_key(CryptoHash *hash, CacheURL *url);
   static void generate_key(HttpCacheKey *hash, CacheURL *url, cache_generation_t generation = -1);
+  /// As above, reusing the hash kept in @a hash_cache if @a url has not changed since it was hashed.
+  static void generate_key(HttpCacheKey *hash, CacheURL *url, URLHashCache &hash_cache, cache_generation_t generation = -1);
 
   Action *link(Continuation *cont, const CacheKey *from, const CacheKey *to, CacheFragType type, const char *hostname,
                int host_len);
@@ -1025,6 +1051,13 @@ Cache::generate_key(HttpCacheKey *key, CacheURL *url, cache_generation_t generat
   url->hash_get(&key->hash, generation);
 }
 
+TS_INLINE void
+Cache::generate_key(HttpCacheKey *key, CacheURL *url, URLHashCache &hash_cache, cache_generation_t generation)
+{
+  key->hostname = url->host_get(&key->hostlen);
+  hash_cache.get(url, &key->hash, generation);
+}
+
 TS_INLINE unsigned int
 cache_hash(const CryptoHash &hash)
 {
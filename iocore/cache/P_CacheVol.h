@@ -174,6 +174,10 @@ struct Vol : public Continuation {
   int64_t first_fragment_offset = 0;
   Ptr<IOBufferData> first_fragment_data;
 
+  /// End of the last write issued, counted in bytes over all laps of the stripe. It only increases and
+  /// is read without the volume lock to check fragments mapped from the span, @see overwrite_mark().
+  std::atomic<uint64_t> write_mark{0};
+
   void cancel_trigger();
 
   int recover_data();
@@ -242,6 +246,9 @@ struct Vol : public Continuation {
   void evacuate_cleanup();
   EvacuationBlock *force_evacuate_head(Dir *dir, int pinned);
   int within_hit_evacuate_window(Dir *dir);
+  int within_write_window(Dir *dir, off_t window);
+  void publish_write_mark();
+  uint64_t overwrite_mark(Dir *dir);
   uint32_t round_to_approx_size(uint32_t l);
 
   // inline functions
@@ -502,14 +509,43 @@ Vol::open_read(const CryptoHash *key)
 
 TS_INLINE int
 Vol::within_hit_evacuate_window(Dir *xdir)
+{
+  return within_write_window(xdir, hit_evacuate_window);
+}
+
+// Whether the write cursor reaches @a xdir within the next @a window blocks.
+TS_INLINE int
+Vol::within_write_window(Dir *xdir, off_t window)
 {
   off_t oft       = dir_offset(xdir) - 1;
   off_t write_off = (header->write_pos + AGG_SIZE - start) / CACHE_BLOCK_SIZE;
   off_t delta     = oft - write_off;
   if (delta >= 0)
-    return delta < hit_evacuate_window;
+    return delta < window;
   else
-    return -delta > (data_blocks - hit_evacuate_window) && -delta < data_blocks;
+    return -delta > (data_blocks - window) && -delta < data_blocks;
+}
+
+// Call whenever agg_pos or the cycle changes, before anything is written. The mark never goes back,
+// if the directory is cleared fragments are simply not mapped until the writer is past the old mark.
+TS_INLINE void
+Vol::publish_write_mark()
+{
+  uint64_t lap  = skip + len - start;
+  uint64_t mark = header->cycle * lap + (header->agg_pos - start);
+  if (mark > write_mark.load(std::memory_order_relaxed)) {
+    write_mark.store(mark, std::memory_order_release);
+  }
+}
+
+// The write_mark at which the writer starts overwriting @a xdir.
+TS_INLINE uint64_t
+Vol::overwrite_mark(Dir *xdir)
+{
+  uint64_t lap   = skip + len - start;
+  uint64_t o     = vol_offset(xdir) - start;
+  uint64_t cycle = header->cycle + (vol_offset(xdir) < header->write_pos ? 1 : 0);
+  return cycle * lap + o;
 }
 
 TS_INLINE uint32_t
@@ -0,0 +1,81 @@
+/** @file
+
+  Cache reads with proxy.config.cache.mmap_fragments
+
+  @section license License
+
+  Licensed to the Apache Software Foundation (ASF) under one
+  or more contributor license agreements.  See the NOTICE file
+  distributed with this work for additional information
+  regarding copyright ownership.  The ASF licenses this file
+  to you under the Apache License, Version 2.0 (the
+  "License"); you may not use this file except in compliance
+  with the License.  You may obtain a copy of the License at
+
+      http://www.apache.org/licenses/LICENSE-2.0
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+ */
+
+#define LARGE_FILE 10 * 1024 * 1024
+
+#include "main.h"
+
+// Reads back what it wrote, allowing the later fragments to be mapped from the span.
+class CacheMappedReadTest : public CacheTestHandler
+{
+public:
+  CacheMappedReadTest(size_t size, const char *url) : CacheTestHandler(size, url) {}
+
+  void
+  handle_cache_event(int event, CacheTestBase *base) override
+  {
+    switch (event) {
+    case CACHE_EVENT_OPEN_READ:
+      base->vc->allow_mapped_fragments();
+      base->do_io_read();
+      break;
+    case VC_EVENT_READ_COMPLETE: {
+      int64_t mapped = 0;
+      RecGetRawStatSum(cache_rsb, cache_mapped_frags_stat, &mapped);
+      CHECK(mapped > 0);
+      CacheTestHandler::handle_cache_event(event, base);
+      break;
+    }
+    default:
+      CacheTestHandler::handle_cache_event(event, base);
+      break;
+    }
+  }
+};
+
+class CacheMapFragmentsInit : public CacheInit
+{
+public:
+  CacheMapFragmentsInit() {}
+  int
+  cache_init_success_callback(int event, void *e) override
+  {
+    CacheMappedReadTest *h = new CacheMappedReadTest(LARGE_FILE, "http://www.scw55.com/");
+    TerminalTest *tt       = new TerminalTest;
+    h->add(tt);
+    this_ethread()->schedule_imm(h);
+    delete this;
+    return 0;
+  }
+};
+
+TEST_CASE("cache mapped fragments", "cache")
+{
+  RecSetRecordInt("proxy.config.cache.mmap_fragments", 1, REC_SOURCE_EXPLICIT);
+  init_cache(256 * 1024 * 1024);
+  cache_config_target_fragment_size = 1 * 1024 * 1024;
+  CacheMapFragmentsInit *init       = new CacheMapFragmentsInit;
+
+  this_ethread()->schedule_imm(init);
+  this_ethread()->execute();
+}
@@ -30,12 +30,63 @@
 
 #include "P_EventSystem.h"
 
+namespace
+{
+enum {
+  IOBUFFER_HUGEPAGE_BYTES,    ///< Bytes in chunks backed by explicit huge pages.
+  IOBUFFER_TRANSPARENT_BYTES, ///< Bytes in chunks advised for transparent huge pages.
+  IOBUFFER_REGULAR_BYTES,     ///< Bytes in chunks backed by regular pages.
+  N_IOBUFFER_STATS
+};
+
+int
+IOBufferMemoryStatSync(const char *, RecDataT, RecData *, RecRawStatBlock *rsb, int)
+{
+  int64_t bytes[N_IOBUFFER_STATS] = {0};
+
+  for (auto &a : ioBufAllocator) {
+    const InkFreeList *fl = a.freelist();
+    int64_t huge          = static_cast<int64_t>(fl->hugepage_allocated) * fl->type_size;
+    int64_t transparent   = static_cast<int64_t>(fl->transparent_allocated) * fl->type_size;
+
+    bytes[IOBUFFER_HUGEPAGE_BYTES] += huge;
+    bytes[IOBUFFER_TRANSPARENT_BYTES] += transparent;
+    bytes[IOBUFFER_REGULAR_BYTES] += static_cast<int64_t>(fl->allocated) * fl->type_size - huge - transparent;
+  }
+
+  ink_mutex_acquire(&(rsb->mutex));
+  for (int id = 0; id < N_IOBUFFER_STATS; ++id) {
+    rsb->global[id]->sum   = bytes[id];
+    rsb->global[id]->count = 1;
+    RecRawStatUpdateSum(rsb, id);
+  }
+  ink_mutex_release(&(rsb->mutex));
+  return REC_ERR_OKAY;
+}
+
+void
+register_iobuffer_stats()
+{
+  RecRawStatBlock *rsb = RecAllocateRawStatBlock(N_IOBUFFER_STATS);
+
+  RecRegisterRawStat(rsb, RECT_PROCESS, "proxy.process.allocator.iobuffer.hugepage_bytes", RECD_INT, RECP_NON_PERSISTENT,
+                     IOBUFFER_HUGEPAGE_BYTES, nullptr);
+  RecRegisterRawStat(rsb, RECT_PROCESS, "proxy.process.allocator.iobuffer.transparent_hugepage_bytes", RECD_INT,
+                     RECP_NON_PERSISTENT, IOBUFFER_TRANSPARENT_BYTES, nullptr);
+  RecRegisterRawStat(rsb, RECT_PROCESS, "proxy.process.allocator.iobuffer.regular_page_bytes", RECD_INT, RECP_NON_PERSISTENT,
+                     IOBUFFER_REGULAR_BYTES, nullptr);
+  // All of the stats are updated in one pass, so register against any one of them.
+  RecRegisterRawStatSyncCb("proxy.process.allocator.iobuffer.hugepage_bytes", IOBufferMemoryStatSync, rsb, 0);
+}
+} // namespace
+
 void
 ink_event_system_init(ts::ModuleVersion v)
 {
   ink_release_assert(v.check(EVENT_SYSTEM_MODULE_INTERNAL_VERSION));
   int config_max_iobuffer_size = DEFAULT_MAX_BUFFER_SIZE;
   int iobuffer_advice          = 0;
+  int iobuffer_hugepages       = 0;
 
   // For backwards compatibility make sure to allow thread_freelist_size
   // This needs to change in 6.0
@@ -62,5 +113,8 @@ ink_event_system_init(ts::ModuleVersion v)
   }
 #endif
 
-  init_buffer_allocators(iobuffer_advice);
+  REC_ReadConfigInteger(iobuffer_hugepages, "proxy.config.allocator.iobuffer_hugepages");
+
+  init_buffer_allocators(iobuffer_advice, iobuffer_hugepages != 0);
+  register_iobuffer_stats();
 }
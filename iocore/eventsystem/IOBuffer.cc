@@ -44,7 +44,7 @@ int64_t max_iobuffer_size           = DEFAULT_BUFFER_SIZES - 1;
 // Initialization
 //
 void
-init_buffer_allocators(int iobuffer_advice)
+init_buffer_allocators(int iobuffer_advice, bool iobuffer_hugepages)
 {
   for (int i = 0; i < DEFAULT_BUFFER_SIZES; i++) {
     int64_t s = DEFAULT_BUFFER_BASE_SIZE * (((int64_t)1) << i);
@@ -56,10 +56,68 @@ init_buffer_allocators(int iobuffer_advice)
 
     auto name = new char[64];
     snprintf(name, 64, "ioBufAllocator[%d]", i);
-    ioBufAllocator[i].re_init(name, s, n, a, iobuffer_advice);
+    ioBufAllocator[i].re_init(name, s, n, a, iobuffer_advice, iobuffer_hugepages);
   }
 }
 
+IOBufferData *
+new_mmap_IOBufferData_internal(
+#ifdef TRACK_BUFFER_USER
+  const char *location,
+#endif
+  int fd, off_t offset, int64_t size, const IOBufferMapGuard &guard)
+{
+  off_t page_offset = offset % ats_pagesize();
+#ifdef MAP_POPULATE
+  void *addr = mmap(nullptr, size + page_offset, PROT_READ, MAP_SHARED | MAP_POPULATE, fd, offset - page_offset);
+#else
+  void *addr = mmap(nullptr, size + page_offset, PROT_READ, MAP_SHARED, fd, offset - page_offset);
+#endif
+
+  if (addr == MAP_FAILED) {
+    return nullptr;
+  }
+#ifndef MAP_POPULATE
+  for (int64_t i = 0; i < size + page_offset; i += ats_pagesize()) {
+    (void)*static_cast<volatile char *>(static_cast<char *>(addr) + i);
+  }
+#endif
+
+  IOBufferData *d = new_constant_IOBufferData_internal(
+#ifdef TRACK_BUFFER_USER
+    location,
+#endif
+    static_cast<char *>(addr) + page_offset, size);
+  d->_mem_type  = MMAPPED;
+  d->_fd        = fd;
+  d->_fd_offset = offset;
+  d->_map_guard = guard;
+  return d;
+}
+
+bool
+IOBufferBlock::copy_mapped_data()
+{
+  IOBufferData *mapped = data.get();
+  int64_t len          = read_avail();
+
+  ink_assert(mapped->_mem_type == MMAPPED);
+
+  char *b = static_cast<char *>(ats_malloc(len));
+  memcpy(b, _start, len);
+  // The writer may have got there while copying.
+  if (!mapped->_map_guard.intact()) {
+    ats_free(b);
+    return false;
+  }
+
+  data     = new_xmalloc_IOBufferData(b, len);
+  _start   = b;
+  _end     = b + len;
+  _buf_end = _end;
+  return true;
+}
+
 int64_t
 MIOBuffer::remove_append(IOBufferReader *r)
 {
@@ -24,6 +24,8 @@
 
 #pragma once
 
+#include <atomic>
+
 #include "tscore/ink_platform.h"
 #include "tscore/ink_rand.h"
 #include "tscore/I_Version.h"
@@ -383,6 +385,24 @@ public:
     friend class EThread;
   } DEFAULT_TAIL_HANDLER = EventQueueExternal;
 
+  /** Number of buckets in the loop and handler time histograms.
+      The upper bounds of the buckets are in @a TIME_BUCKET_LIMIT, the last bucket is unbounded.
+  */
+  static int const N_TIME_BUCKETS = 12;
+  /// Upper bound (exclusive) of each histogram bucket.
+  static ink_hrtime const TIME_BUCKET_LIMIT[N_TIME_BUCKETS - 1];
+
+  /// Histogram bucket index for a duration of @a delta.
+  static int
+  time_bucket(ink_hrtime delta)
+  {
+    int idx = 0;
+    while (idx < N_TIME_BUCKETS - 1 && delta >= TIME_BUCKET_LIMIT[idx]) {
+      ++idx;
+    }
+    return idx;
+  }
+
   /// Statistics data for event dispatching.
   struct EventMetrics {
     /// Time the loop was active, not including wait time but including event dispatch time.
@@ -390,9 +410,18 @@ public:
       ink_hrtime _start = 0;         ///< The time of the first loop for this sample. Used to mark valid entries.
       ink_hrtime _min   = INT64_MAX; ///< Shortest loop time.
       ink_hrtime _max   = 0;         ///< Longest loop time.
+      int _hist[N_TIME_BUCKETS]{};   ///< Distribution of loop times.
       LoopTimes() {}
     } _loop_time;
 
+    /// Time spent in individual continuation handlers.
+    /// Only collected if @c thread_handler_stall_mseconds is set.
+    struct HandlerTimes {
+      int _hist[N_TIME_BUCKETS]{}; ///< Distribution of handler times.
+      int _stalls = 0;             ///< # of handler calls that exceeded the stall threshold.
+      HandlerTimes() {}
+    } _handler_time;
+
     struct Events {
       int _min   = INT_MAX;
       int _max   = 0;
@@ -432,7 +461,10 @@ public:
     STAT_LOOP_WAIT,       ///< # of loops that did a conditional wait.
     STAT_LOOP_TIME_MIN,   ///< Shortest time spent in loop.
     STAT_LOOP_TIME_MAX,   ///< Longest time spent in loop.
-    N_EVENT_STATS         ///< NOT A VALID STAT INDEX - # of different stat types.
+    STAT_LOOP_TIME_HIST,  ///< First bucket of the loop time histogram.
+    STAT_HANDLER_TIME_HIST = STAT_LOOP_TIME_HIST + N_TIME_BUCKETS, ///< First bucket of the handler time histogram.
+    STAT_HANDLER_STALLS    = STAT_HANDLER_TIME_HIST + N_TIME_BUCKETS, ///< # of handler calls over the stall threshold.
+    N_EVENT_STATS ///< NOT A VALID STAT INDEX - # of different stat types.
   };
 
   static char const *const STAT_NAME[N_EVENT_STATS];
@@ -458,6 +490,35 @@ public:
   {
     return const_cast<EventMetrics *>(++current > &metrics[N_EVENT_METRICS - 1] ? metrics : current); // cast to remove volatile
   }
+
+  /** The handler currently being dispatched, for the stall watchdog.
+
+      This is only maintained if @c thread_handler_stall_mseconds is set. The handler address is
+      copied out of the continuation before dispatch so that it can be reported safely from another
+      thread even if the continuation is destroyed by the handler. The watchdog reads the fields
+      between two loads of @a _start and drops them if it changed, as with a sequence lock.
+  */
+  struct DispatchState {
+    std::atomic<ink_hrtime> _start{0}; ///< Time the handler was called, 0 if not in a handler.
+    std::atomic<void *> _handler{nullptr};
+    std::atomic<const char *> _handler_name{nullptr};
+    std::atomic<Continuation *> _cont{nullptr};
+    ink_hrtime _reported = 0; ///< @a _start value of the last dispatch reported by the watchdog.
+  } dispatch;
+
+  /** Publish a call into @a c in @a dispatch, for calls made outside of @c process_event, such as
+      the net handler's I/O callbacks. Only call this if @c thread_handler_stall_mseconds is set.
+
+      @return The start time to pass to @c dispatch_end.
+  */
+  ink_hrtime dispatch_begin(Continuation *c);
+  /// Account for the call started at @a start having returned.
+  void dispatch_end(ink_hrtime start);
+
+  /// Log the handler in @a dispatch as having run for @a elapsed since @a start. @a in_progress is
+  /// set if the handler has not returned yet (i.e. this is called from the watchdog), nothing is
+  /// logged then if the thread moved on while the handler was read.
+  void report_stall(ink_hrtime start, ink_hrtime elapsed, bool in_progress);
 };
 
 /**
@@ -479,3 +540,4 @@ operator new(size_t, ink_dummy_for_new *p)
 extern EThread *this_ethread();
 
 extern int thread_max_heartbeat_mseconds;
+extern int thread_handler_stall_mseconds;
@@ -222,6 +222,15 @@ public:
   */
   void *cookie = nullptr;
 
+  /**
+    If set, called by the thread that dispatches this event, with the
+    event's mutex held, right before the continuation handles it. It is
+    not called for an event that was cancelled first. Set it before the
+    event is scheduled.
+
+  */
+  void (*dispatch_hook)(Event *e) = nullptr;
+
   // Private
 
   Event();
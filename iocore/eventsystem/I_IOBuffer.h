@@ -46,6 +46,8 @@
 #include "tscore/ink_assert.h"
 #include "tscore/ink_resource.h"
 
+#include <atomic>
+
 struct MIOBufferAccessor;
 
 class MIOBuffer;
@@ -70,6 +72,35 @@ enum AllocType {
   MEMALIGNED,
   DEFAULT_ALLOC,
   CONSTANT,
+  MMAPPED,
+};
+
+/**
+  Tells whether the bytes behind MMAPPED data are still the ones that were
+  mapped. The owner of the file publishes how far its writer has got in
+  @a position, which only increases. The mapped bytes are overwritten
+  once it passes @a limit.
+
+*/
+struct IOBufferMapGuard {
+  const std::atomic<uint64_t> *position = nullptr;
+  uint64_t limit                        = 0;
+  /// How close @a position may get to @a limit before the bytes are no longer used in place.
+  uint64_t margin = 0;
+
+  /// The bytes can still be used in place.
+  bool
+  safe() const
+  {
+    return position == nullptr || position->load(std::memory_order_acquire) + margin <= limit;
+  }
+
+  /// The bytes have not been overwritten yet, so a copy made before this check is good.
+  bool
+  intact() const
+  {
+    return position == nullptr || position->load(std::memory_order_acquire) <= limit;
+  }
 };
 
 #define DEFAULT_BUFFER_NUMBER 128
@@ -125,7 +156,7 @@ enum AllocType {
 
 inkcoreapi extern Allocator ioBufAllocator[DEFAULT_BUFFER_SIZES];
 
-void init_buffer_allocators(int iobuffer_advice);
+void init_buffer_allocators(int iobuffer_advice, bool iobuffer_hugepages = false);
 
 /**
   A reference counted wrapper around fast allocated or malloced memory.
@@ -249,6 +280,16 @@ public:
   */
   char *_data = nullptr;
 
+  /**
+    For MMAPPED data, the file descriptor the memory is mapped from and
+    the file offset of '_data'. Writers to a socket may send such bytes
+    with sendfile() instead of touching the mapping.
+
+  */
+  int _fd          = -1;
+  off_t _fd_offset = 0;
+  IOBufferMapGuard _map_guard;
+
 #ifdef TRACK_BUFFER_USER
   const char *_location = nullptr;
 #endif
@@ -471,6 +512,16 @@ public:
   void realloc_xmalloc(void *b, int64_t buf_size);
   void realloc_xmalloc(int64_t buf_size);
 
+  /**
+    Replace MMAPPED data with a private copy of the bytes this block
+    references, for when the guard of the mapping is no longer safe.
+
+    @return @c false if the mapped bytes were overwritten before they
+      could be copied, the block is left unchanged then.
+
+  */
+  bool copy_mapped_data();
+
   /**
     Frees the IOBufferBlock object and its underlying memory.
     Removes the reference to the IOBufferData object and then frees
@@ -1473,6 +1524,22 @@ extern IOBufferData *new_constant_IOBufferData_internal(
 #endif
   void *b, int64_t size);
 
+/**
+  Map @a size bytes of @a fd at @a offset read only. The pages are read
+  in before this returns, so it may block on the disk and must not be
+  called on a net thread. The mapping is released when the IOBufferData
+  is freed, @a fd must stay open until then. Consumers must check
+  @a guard before they use the bytes.
+
+  @return the data, or @c nullptr if the mapping failed.
+
+*/
+extern IOBufferData *new_mmap_IOBufferData_internal(
+#ifdef TRACK_BUFFER_USER
+  const char *location,
+#endif
+  int fd, off_t offset, int64_t size, const IOBufferMapGuard &guard);
+
 #ifdef TRACK_BUFFER_USER
 class IOBufferData_tracker
 {
@@ -1492,10 +1559,13 @@ public:
 #define new_IOBufferData IOBufferData_tracker(RES_PATH("memory/IOBuffer/"))
 #define new_xmalloc_IOBufferData(b, size) new_xmalloc_IOBufferData_internal(RES_PATH("memory/IOBuffer/"), (b), (size))
 #define new_constant_IOBufferData(b, size) new_constant_IOBufferData_internal(RES_PATH("memory/IOBuffer/"), (b), (size))
+#define new_mmap_IOBufferData(fd, offset, size, guard) \
+  new_mmap_IOBufferData_internal(RES_PATH("memory/IOBuffer/"), (fd), (offset), (size), (guard))
 #else
 #define new_IOBufferData new_IOBufferData_internal
 #define new_xmalloc_IOBufferData new_xmalloc_IOBufferData_internal
 #define new_constant_IOBufferData new_constant_IOBufferData_internal
+#define new_mmap_IOBufferData new_mmap_IOBufferData_internal
 #endif
 
 extern int64_t iobuffer_size_to_index(int64_t size, int64_t max = max_iobuffer_size);
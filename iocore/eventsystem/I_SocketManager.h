@@ -87,6 +87,8 @@ struct SocketManager {
 
   int64_t write(int fd, void *buf, int len, void *pOLP = nullptr);
   int64_t writev(int fd, struct iovec *vector, size_t count);
+  /// Send @a count bytes of @a in_fd starting at @a offset to @a fd, -ENOSYS where sendfile() is not available.
+  int64_t sendfile(int fd, int in_fd, off_t offset, int64_t count);
   int64_t write_vector(int fd, struct iovec *vector, size_t count, void *pOLP = nullptr);
   int64_t pwrite(int fd, void *buf, int len, off_t offset, char *tag = nullptr);
 
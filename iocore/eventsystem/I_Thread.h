@@ -130,7 +130,9 @@ public:
   ProxyAllocator quicStreamManagerAllocator;
   ProxyAllocator httpServerSessionAllocator;
   ProxyAllocator hdrHeapAllocator;
+  ProxyAllocator hdrHeapLargeAllocator;
   ProxyAllocator strHeapAllocator;
+  ProxyAllocator strHeapLargeAllocator;
   ProxyAllocator cacheVConnectionAllocator;
   ProxyAllocator openDirEntryAllocator;
   ProxyAllocator ramCacheCLFUSEntryAllocator;
@@ -324,6 +324,14 @@ IOBufferData::dealloc()
       ::free((void *)_data);
     }
     break;
+  case MMAPPED: {
+    off_t page_offset = _fd_offset % ats_pagesize();
+    munmap(_data - page_offset, BUFFER_SIZE_FOR_CONSTANT(_size_index) + page_offset);
+    _fd        = -1;
+    _fd_offset = 0;
+    _map_guard = IOBufferMapGuard();
+    break;
+  }
   default:
   case DEFAULT_ALLOC:
     if (BUFFER_SIZE_INDEX_IS_FAST_ALLOCATED(_size_index)) {
@@ -34,6 +34,8 @@
 #include <sys/eventfd.h>
 #endif
 
+#include <dlfcn.h>
+
 struct AIOCallback;
 
 #define NO_HEARTBEAT -1
@@ -43,11 +45,31 @@ struct AIOCallback;
 char const *const EThread::STAT_NAME[] = {"proxy.process.eventloop.count",      "proxy.process.eventloop.events",
                                           "proxy.process.eventloop.events.min", "proxy.process.eventloop.events.max",
                                           "proxy.process.eventloop.wait",       "proxy.process.eventloop.time.min",
-                                          "proxy.process.eventloop.time.max"};
+                                          "proxy.process.eventloop.time.max",
+                                          // loop time histogram, in TIME_BUCKET_LIMIT order.
+                                          "proxy.process.eventloop.time.hist.10us", "proxy.process.eventloop.time.hist.50us",
+                                          "proxy.process.eventloop.time.hist.100us", "proxy.process.eventloop.time.hist.500us",
+                                          "proxy.process.eventloop.time.hist.1ms", "proxy.process.eventloop.time.hist.5ms",
+                                          "proxy.process.eventloop.time.hist.10ms", "proxy.process.eventloop.time.hist.50ms",
+                                          "proxy.process.eventloop.time.hist.100ms", "proxy.process.eventloop.time.hist.500ms",
+                                          "proxy.process.eventloop.time.hist.1s", "proxy.process.eventloop.time.hist.inf",
+                                          // handler time histogram, in TIME_BUCKET_LIMIT order.
+                                          "proxy.process.eventloop.handler.hist.10us", "proxy.process.eventloop.handler.hist.50us",
+                                          "proxy.process.eventloop.handler.hist.100us", "proxy.process.eventloop.handler.hist.500us",
+                                          "proxy.process.eventloop.handler.hist.1ms", "proxy.process.eventloop.handler.hist.5ms",
+                                          "proxy.process.eventloop.handler.hist.10ms", "proxy.process.eventloop.handler.hist.50ms",
+                                          "proxy.process.eventloop.handler.hist.100ms", "proxy.process.eventloop.handler.hist.500ms",
+                                          "proxy.process.eventloop.handler.hist.1s", "proxy.process.eventloop.handler.hist.inf",
+                                          "proxy.process.eventloop.handler.stalls"};
 
 int const EThread::SAMPLE_COUNT[N_EVENT_TIMESCALES] = {10, 100, 1000};
 
+ink_hrtime const EThread::TIME_BUCKET_LIMIT[N_TIME_BUCKETS - 1] = {
+  HRTIME_USECONDS(10), HRTIME_USECONDS(50), HRTIME_USECONDS(100), HRTIME_USECONDS(500), HRTIME_MSECONDS(1), HRTIME_MSECONDS(5),
+  HRTIME_MSECONDS(10), HRTIME_MSECONDS(50), HRTIME_MSECONDS(100), HRTIME_MSECONDS(500), HRTIME_SECONDS(1)};
+
 int thread_max_heartbeat_mseconds = THREAD_MAX_HEARTBEAT_MSECONDS;
+int thread_handler_stall_mseconds = 0;
 
 EThread::EThread()
 {
@@ -127,13 +149,22 @@ EThread::process_event(Event *e, int calling_code)
       free_event(e);
       return;
     }
+    if (e->dispatch_hook) {
+      e->dispatch_hook(e);
+    }
     Continuation *c_temp = e->continuation;
     // Make sure that the continuation is locked before calling the handler
 
     // Restore the client IP debugging flags
     set_cont_flags(e->continuation->control_flags);
 
-    e->continuation->handleEvent(calling_code, e);
+    if (thread_handler_stall_mseconds > 0) {
+      ink_hrtime start = this->dispatch_begin(e->continuation);
+      e->continuation->handleEvent(calling_code, e);
+      this->dispatch_end(start);
+    } else {
+      e->continuation->handleEvent(calling_code, e);
+    }
     ink_assert(!e->in_the_priority_queue);
     ink_assert(c_temp == e->continuation);
     MUTEX_RELEASE(lock);
@@ -284,6 +315,7 @@ EThread::execute_regular()
     // tried using the monotonic clock to get around this but it was *very* stuttery (up to hundreds
     // of milliseconds), far too much to be actually used.
     if (delta > 0) {
+      ++(current_metric->_loop_time._hist[time_bucket(delta)]);
       if (delta > current_metric->_loop_time._max) {
         current_metric->_loop_time._max = delta;
       }
@@ -357,11 +389,78 @@ EThread::EventMetrics::operator+=(EventMetrics const &that)
   this->_events._total += that._events._total;
   this->_loop_time._min = std::min(this->_loop_time._min, that._loop_time._min);
   this->_loop_time._max = std::max(this->_loop_time._max, that._loop_time._max);
+  for (int i = 0; i < N_TIME_BUCKETS; ++i) {
+    this->_loop_time._hist[i] += that._loop_time._hist[i];
+    this->_handler_time._hist[i] += that._handler_time._hist[i];
+  }
+  this->_handler_time._stalls += that._handler_time._stalls;
   this->_count += that._count;
   this->_wait += that._wait;
   return *this;
 }
 
+ink_hrtime
+EThread::dispatch_begin(Continuation *c)
+{
+  void *handler_addr = nullptr;
+  // The leading word of a member function pointer is the function address for non-virtual handlers.
+  memcpy(&handler_addr, &c->handler, sizeof(handler_addr));
+
+  ink_assert(dispatch._start.load(std::memory_order_relaxed) == 0);
+  // Pairs with the fence in report_stall(), a watchdog that sees these stores also sees that the
+  // dispatch it started to read has ended.
+  std::atomic_thread_fence(std::memory_order_release);
+  dispatch._handler.store(handler_addr, std::memory_order_relaxed);
+#ifdef DEBUG
+  dispatch._handler_name.store(c->handler_name, std::memory_order_relaxed);
+#endif
+  dispatch._cont.store(c, std::memory_order_relaxed);
+
+  ink_hrtime start = Thread::get_hrtime_updated();
+  dispatch._start.store(start, std::memory_order_release);
+  return start;
+}
+
+void
+EThread::dispatch_end(ink_hrtime start)
+{
+  ink_hrtime elapsed = Thread::get_hrtime_updated() - start;
+
+  dispatch._start.store(0, std::memory_order_release);
+  if (elapsed > 0) {
+    ++(current_metric->_handler_time._hist[time_bucket(elapsed)]);
+    if (elapsed >= HRTIME_MSECONDS(thread_handler_stall_mseconds)) {
+      ++(current_metric->_handler_time._stalls);
+      this->report_stall(start, elapsed, false);
+    }
+  }
+}
+
+void
+EThread::report_stall(ink_hrtime start, ink_hrtime elapsed, bool in_progress)
+{
+  void *handler_addr = dispatch._handler.load(std::memory_order_relaxed);
+  const char *name   = dispatch._handler_name.load(std::memory_order_relaxed);
+  Continuation *cont = dispatch._cont.load(std::memory_order_relaxed);
+
+  if (in_progress) {
+    std::atomic_thread_fence(std::memory_order_acquire);
+    if (dispatch._start.load(std::memory_order_relaxed) != start) {
+      return; // the handler returned while being read, the fields may belong to the next one
+    }
+  }
+
+  // Prefer the SET_HANDLER name (debug builds), fall back to the symbol.
+  Dl_info info;
+  if (name == nullptr && dladdr(handler_addr, &info) && info.dli_sname) {
+    name = info.dli_sname;
+  }
+
+  Warning("event thread [%d] %s %" PRId64 " ms in handler %s (%p) of continuation %p", id,
+          in_progress ? "has been blocked for" : "was blocked for", static_cast<int64_t>(ink_hrtime_to_msec(elapsed)),
+          name ? name : "<unknown>", handler_addr, cont);
+}
+
 void
 EThread::summarize_stats(EventMetrics summary[N_EVENT_TIMESCALES])
 {
@@ -31,6 +31,7 @@
 #endif
 #include "tscore/ink_defs.h"
 #include "tscore/hugepages.h"
+#include "tscore/TSSystemState.h"
 
 /// Global singleton.
 class EventProcessor eventProcessor;
@@ -112,12 +113,53 @@ EventMetricStatSync(const char *, RecDataT, RecData *, RecRawStatBlock *rsb, int
     rsb->global[id + EThread::STAT_LOOP_EVENTS_MAX]->sum   = m->_events._max;
     rsb->global[id + EThread::STAT_LOOP_EVENTS_MAX]->count = 1;
     RecRawStatUpdateSum(rsb, id + EThread::STAT_LOOP_EVENTS_MAX);
+
+    for (int b = 0; b < EThread::N_TIME_BUCKETS; ++b) {
+      rsb->global[id + EThread::STAT_LOOP_TIME_HIST + b]->sum   = m->_loop_time._hist[b];
+      rsb->global[id + EThread::STAT_LOOP_TIME_HIST + b]->count = 1;
+      RecRawStatUpdateSum(rsb, id + EThread::STAT_LOOP_TIME_HIST + b);
+      rsb->global[id + EThread::STAT_HANDLER_TIME_HIST + b]->sum   = m->_handler_time._hist[b];
+      rsb->global[id + EThread::STAT_HANDLER_TIME_HIST + b]->count = 1;
+      RecRawStatUpdateSum(rsb, id + EThread::STAT_HANDLER_TIME_HIST + b);
+    }
+    rsb->global[id + EThread::STAT_HANDLER_STALLS]->sum   = m->_handler_time._stalls;
+    rsb->global[id + EThread::STAT_HANDLER_STALLS]->count = 1;
+    RecRawStatUpdateSum(rsb, id + EThread::STAT_HANDLER_STALLS);
   }
 
   ink_mutex_release(&(rsb->mutex));
   return REC_ERR_OKAY;
 }
 
+/// Runs on a dedicated thread and reports event threads that have been inside a single handler
+/// call for longer than @c thread_handler_stall_mseconds. Threads that eventually return are also
+/// reported by the event thread itself, this catches the ones that never do.
+class StallWatchdog : public Continuation
+{
+public:
+  StallWatchdog() : Continuation(nullptr) { SET_HANDLER(&StallWatchdog::run); }
+
+  int
+  run(int, Event *)
+  {
+    ink_hrtime threshold = HRTIME_MSECONDS(thread_handler_stall_mseconds);
+
+    while (!TSSystemState::is_event_system_shut_down()) {
+      ink_hrtime_sleep(threshold / 2);
+      ink_hrtime now = ink_get_hrtime_internal();
+      for (EThread *t : eventProcessor.active_ethreads()) {
+        ink_hrtime start = t->dispatch._start.load(std::memory_order_acquire);
+        // Report each stalled dispatch once.
+        if (start != 0 && start != t->dispatch._reported && now - start >= threshold) {
+          t->dispatch._reported = start;
+          t->report_stall(start, now - start, true);
+        }
+      }
+    }
+    return EVENT_DONE;
+  }
+};
+
 /// This is a wrapper used to convert a static function into a continuation. The function pointer is
 /// passed in the cookie. For this reason the class is used as a singleton.
 /// @internal This is the implementation for @c schedule_spawn... overloads.
@@ -448,6 +490,10 @@ EventProcessor::start(int n_event_threads, size_t stacksize)
   this->spawn_event_threads(ET_CALL, n_event_threads, stacksize);
 
   Debug("iocore_thread", "Created event thread group id %d with %d threads", ET_CALL, n_event_threads);
+
+  if (thread_handler_stall_mseconds > 0) {
+    this->spawn_thread(new StallWatchdog, "[STALL_WATCHDOG]", stacksize);
+  }
   return 0;
 }
 
@@ -60,5 +60,66 @@ main(int /* argc ATS_UNUSED */, const char * /* argv ATS_UNUSED */ [])
     free_MIOBuffer(b1);
   }
 
+  // Writing from a reader shares its blocks instead of copying the data.
+  {
+    MIOBuffer *src             = new_MIOBuffer(default_large_iobuffer_size);
+    IOBufferReader *src_reader = src->alloc_reader();
+    src->fill(src->write_avail());
+    int64_t avail    = src_reader->read_avail();
+    char const *data = src_reader->start();
+
+    MIOBuffer *dst             = new_MIOBuffer(default_large_iobuffer_size);
+    IOBufferReader *dst_reader = dst->alloc_reader();
+
+    ink_release_assert(dst->write(src_reader, avail / 2) == avail / 2);
+    src_reader->consume(avail / 2);
+    ink_release_assert(src_reader->read_avail() == avail - avail / 2);
+    ink_release_assert(dst_reader->read_avail() == avail / 2);
+    ink_release_assert(dst_reader->start() == data);
+
+    free_MIOBuffer(dst);
+    free_MIOBuffer(src);
+  }
+
+  // Mapped data is copied once its guard is no longer safe, and lost once the writer of the file passed it.
+  {
+    char path[] = "/tmp/test_Buffer.XXXXXX";
+    int fd      = mkstemp(path);
+    ink_release_assert(fd >= 0);
+    unlink(path);
+    char page[4096];
+    memset(page, 'm', sizeof(page));
+    ink_release_assert(write(fd, page, sizeof(page)) == sizeof(page));
+
+    std::atomic<uint64_t> position{0};
+    IOBufferMapGuard guard;
+    guard.position = &position;
+    guard.limit    = 1000;
+    guard.margin   = 100;
+
+    Ptr<IOBufferData> d = make_ptr(new_mmap_IOBufferData(fd, 0, sizeof(page), guard));
+    ink_release_assert(d && d->_mem_type == MMAPPED && d->_fd == fd);
+    ink_release_assert(d->_map_guard.safe() && d->_map_guard.intact());
+
+    Ptr<IOBufferBlock> copied = make_ptr(new_IOBufferBlock(d, sizeof(page) / 2, sizeof(page) / 4));
+    Ptr<IOBufferBlock> lost   = make_ptr(new_IOBufferBlock(d, sizeof(page), 0));
+
+    position = 950;
+    ink_release_assert(!d->_map_guard.safe() && d->_map_guard.intact());
+    ink_release_assert(copied->copy_mapped_data());
+    ink_release_assert(copied->data->_mem_type != MMAPPED);
+    ink_release_assert(copied->read_avail() == static_cast<int64_t>(sizeof(page) / 2));
+    ink_release_assert(memcmp(copied->start(), page, sizeof(page) / 2) == 0);
+
+    position = 1001;
+    ink_release_assert(!d->_map_guard.intact());
+    ink_release_assert(!lost->copy_mapped_data());
+    ink_release_assert(lost->data == d);
+
+    lost.clear();
+    d.clear();
+    close(fd);
+  }
+
   exit(0);
 }
@@ -61,6 +61,13 @@ extern int net_accept_period;
 extern int net_retry_delay;
 extern int net_throttle_delay;
 
+extern int listen_per_thread;
+
+extern int net_splice_tunnel;
+extern int net_splice_pipe_size;
+extern int net_sock_notsent_lowat;
+extern int net_tcp_write_sizing;
+
 extern std::string_view net_ccp_in;
 extern std::string_view net_ccp_out;
 
@@ -77,6 +84,7 @@ extern std::string_view net_ccp_out;
 #define NET_EVENT_DATAGRAM_READ_READY (NET_EVENT_EVENTS_START + 10)
 #define NET_EVENT_DATAGRAM_OPEN (NET_EVENT_EVENTS_START + 11)
 #define NET_EVENT_DATAGRAM_ERROR (NET_EVENT_EVENTS_START + 12)
+#define NET_EVENT_SPLICE_DONE (NET_EVENT_EVENTS_START + 13)
 #define NET_EVENT_ACCEPT_INTERNAL (NET_EVENT_EVENTS_START + 22)
 #define NET_EVENT_CONNECT_INTERNAL (NET_EVENT_EVENTS_START + 23)
 
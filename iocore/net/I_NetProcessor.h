@@ -24,6 +24,8 @@
 
 #pragma once
 
+#include <vector>
+
 #include "tscore/IpMap.h"
 #include "I_EventSystem.h"
 #include "I_Socks.h"
@@ -106,6 +108,10 @@ public:
     /// Proxy Protocol enabled
     bool f_proxy_protocol;
 
+    /// Sockets already bound to the port for the other net threads. With
+    /// proxy.config.exec_thread.listen these are used before any new socket is opened.
+    std::vector<int> thread_fds;
+
     /// Default constructor.
     /// Instance is constructed with default values.
     AcceptOptions() { this->reset(); }
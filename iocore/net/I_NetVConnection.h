@@ -690,6 +690,20 @@ public:
     is_transparent = state;
   }
 
+  /// Get whether this connection carries a multiplexed (e.g. HTTP/2) session.
+  bool
+  get_is_multiplexed() const
+  {
+    return is_multiplexed;
+  }
+
+  /// Mark this connection as carrying a multiplexed session, these are shed first under resource pressure.
+  void
+  set_is_multiplexed(bool state = true)
+  {
+    is_multiplexed = state;
+  }
+
   /// Get the proxy protocol enabled flag
   bool
   get_is_proxy_protocol() const
@@ -838,6 +852,8 @@ protected:
   bool is_transparent = false;
   /// Set if proxy protocol is enabled
   bool is_proxy_protocol = false;
+  /// Set if this connection carries a multiplexed session.
+  bool is_multiplexed = false;
   /// This is essentially a tri-state, we leave it undefined to mean no MPTCP support
   std::optional<bool> mptcp_state;
   /// Set if the next write IO that empties the write buffer should generate an event.
@@ -98,8 +98,10 @@ public:
      Required for  and UDPNetProcessor::CreateUDPSocket.  They  don't do
      bindToThread() automatically so that the sockets can be passed to
      other Continuations.
+
+     If @a t is given the socket is polled by that ET_UDP thread, otherwise one is assigned.
   */
-  void bindToThread(Continuation *c);
+  void bindToThread(Continuation *c, EThread *t = nullptr);
 
   virtual void UDPConnection_is_abstract() = 0;
 };
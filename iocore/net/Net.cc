@@ -40,6 +40,17 @@ int net_accept_period       = 10;
 int net_retry_delay         = 10;
 int net_throttle_delay      = 50; /* milliseconds */
 
+// Each ET_NET thread listens on its own SO_REUSEPORT socket.
+int listen_per_thread = 0;
+
+// Blind tunnels move bytes with splice(2) when possible, see SpliceTunnel.
+int net_splice_tunnel    = 0;
+int net_splice_pipe_size = 0;
+
+// TCP_NOTSENT_LOWAT for all TCP sockets, and sizing of writes from TCP_INFO.
+int net_sock_notsent_lowat = 0;
+int net_tcp_write_sizing   = 0;
+
 // For the in/out congestion control: ToDo: this probably would be better as ports: specifications
 std::string_view net_ccp_in;
 std::string_view net_ccp_out;
@@ -52,10 +63,15 @@ configure_net()
 
   REC_EstablishStaticConfigInt32(net_retry_delay, "proxy.config.net.retry_delay");
   REC_EstablishStaticConfigInt32(net_throttle_delay, "proxy.config.net.throttle_delay");
+  REC_EstablishStaticConfigInt32(net_splice_tunnel, "proxy.config.net.splice_tunnel.enabled");
+  REC_EstablishStaticConfigInt32(net_sock_notsent_lowat, "proxy.config.net.sock_notsent_lowat");
+  REC_EstablishStaticConfigInt32(net_tcp_write_sizing, "proxy.config.net.tcp_write_sizing.enabled");
 
   // These are not reloadable
   REC_ReadConfigInteger(net_event_period, "proxy.config.net.event_period");
   REC_ReadConfigInteger(net_accept_period, "proxy.config.net.accept_period");
+  REC_ReadConfigInteger(listen_per_thread, "proxy.config.exec_thread.listen");
+  REC_ReadConfigInteger(net_splice_pipe_size, "proxy.config.net.splice_tunnel.pipe_size");
 
   // This is kinda fugly, but better than it was before (on every connection in and out)
   // Note that these would need to be ats_free()'d if we ever want to clean that up, but
@@ -84,9 +100,18 @@ register_net_stats()
     {"proxy.process.net.calls_to_write_nodata", net_calls_to_write_nodata_stat},
     {"proxy.process.net.calls_to_writetonet", net_calls_to_writetonet_stat},
     {"proxy.process.net.calls_to_writetonet_afterpoll", net_calls_to_writetonet_afterpoll_stat},
+    {"proxy.process.net.connections_shed.max_connections", net_connections_shed_max_connections_stat},
+    {"proxy.process.net.connections_shed.fd_pressure", net_connections_shed_fd_pressure_stat},
+    {"proxy.process.net.connections_shed.memory_pressure", net_connections_shed_memory_pressure_stat},
+    {"proxy.process.net.connections_shed.multiplexed", net_connections_shed_multiplexed_stat},
     {"proxy.process.net.inactivity_cop_lock_acquire_failure", inactivity_cop_lock_acquire_failure_stat},
     {"proxy.process.net.net_handler_run", net_handler_run_stat},
     {"proxy.process.net.read_bytes", net_read_bytes_stat},
+    {"proxy.process.net.sendfile_bytes", net_sendfile_bytes_stat},
+    {"proxy.process.net.splice_tunnels", net_splice_tunnels_stat},
+    {"proxy.process.net.splice_bytes", net_splice_bytes_stat},
+    {"proxy.process.net.tcp_write_sizing.sized_writes", net_tcp_write_sized_stat},
+    {"proxy.process.net.io_budget_deferred", net_io_budget_deferred_stat},
     {"proxy.process.net.write_bytes", net_write_bytes_stat},
     {"proxy.process.net.fastopen_out.attempts", net_fastopen_attempts_stat},
     {"proxy.process.net.fastopen_out.successes", net_fastopen_successes_stat},
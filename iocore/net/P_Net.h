@@ -57,6 +57,15 @@ enum Net_Stats {
   net_tcp_accept_stat,
   net_connections_throttled_in_stat,
   net_connections_throttled_out_stat,
+  net_connections_shed_max_connections_stat,
+  net_connections_shed_fd_pressure_stat,
+  net_connections_shed_memory_pressure_stat,
+  net_connections_shed_multiplexed_stat,
+  net_splice_tunnels_stat,
+  net_splice_bytes_stat,
+  net_sendfile_bytes_stat,
+  net_tcp_write_sized_stat,
+  net_io_budget_deferred_stat,
   Net_Stat_Count
 };
 
@@ -99,6 +108,7 @@ extern RecRawStatBlock *net_rsb;
 #include "P_UnixNetProcessor.h"
 #include "P_NetAccept.h"
 #include "P_UnixNetVConnection.h"
+#include "P_SpliceTunnel.h"
 #include "P_UnixPollDescriptor.h"
 #include "P_Socks.h"
 #include "P_CompletionUtil.h"
@@ -88,6 +88,8 @@ struct NetAccept : public Continuation {
   int id                      = -1;
   Ptr<NetAcceptAction> action_;
   SSLNextProtocolAccept *snpa = nullptr;
+  /// server.fd belongs to the NetAccept this one was cloned from, which is the one that closes it.
+  bool shared_fd = false;
   EventIO ep;
 
   HttpProxyPort *proxyPort = nullptr;
@@ -98,6 +100,9 @@ struct NetAccept : public Continuation {
   virtual void init_accept(EThread *t = nullptr);
   void init_accept_loop();
   void init_accept_per_thread();
+  /// The accepts for @a n threads, clones of this one and then this one itself.
+  /// With @a reuseport each has its own socket for the port where one can be had.
+  std::vector<NetAccept *> clone_per_thread(int n, bool reuseport);
   virtual void stop_accept();
   virtual NetAccept *clone() const;
 
@@ -25,6 +25,7 @@
 #define __P_QUICNET_H__
 
 #include <bitset>
+#include <unordered_map>
 
 #include "tscore/ink_platform.h"
 
@@ -38,6 +39,8 @@ void initialize_thread_for_quic_net(EThread *thread);
 struct QUICPollEvent {
   QUICConnection *con;
   UDPPacketInternal *packet;
+  // Set instead of con for packets steered here by their connection ID, the connection is looked up on this thread.
+  QUICPacketHandlerIn *handler = nullptr;
   void init(QUICConnection *con, UDPPacketInternal *packet);
   void free();
 
@@ -58,15 +61,42 @@ public:
   // Atomic Queue to save incoming packets
   ASLL(QUICPollEvent, alink) inQueue;
 
+  // Index of this thread among the ET_NET threads, put in the connection IDs of the connections it owns.
+  uint8_t owner_tag = 0;
+
 private:
   // Internal Queue to save Long Header Packet
   Que(UDPPacketInternal, link) _longInQueue;
 
+  struct CidHash {
+    size_t
+    operator()(const QUICConnectionId &cid) const
+    {
+      return static_cast<uint64_t>(cid);
+    }
+  };
+
+  // Connections of this thread found by steered packets. Only this thread touches it, each entry
+  // holds a reference so the connection stays valid until it is swept after closing.
+  std::unordered_map<QUICConnectionId, QUICNetVConnection *, CidHash> _connections;
+  ink_hrtime _next_sweep = 0;
+
 private:
+  bool _resolve_steered_packet(QUICPollEvent *e);
+  QUICNetVConnection *_find_connection(const QUICConnectionId &cid, QUICConnectionTable &ctable);
+  void _sweep_connections();
   void _process_short_header_packet(QUICPollEvent *e, NetHandler *nh);
   void _process_long_header_packet(QUICPollEvent *e, NetHandler *nh);
 };
 
+// The thread that owns connections whose IDs carry @a tag, or nullptr if there is none.
+static inline EThread *
+get_QUICOwnerThread(uint8_t tag)
+{
+  auto threads = eventProcessor.active_group_threads(ET_NET);
+  return tag < threads.end() - threads.begin() ? threads.begin()[tag] : nullptr;
+}
+
 static inline QUICPollCont *
 get_QUICPollCont(EThread *t)
 {
@@ -76,12 +76,16 @@ public:
   virtual int acceptEvent(int event, void *e) override;
   void init_accept(EThread *t) override;
 
+  QUICConnectionTable &connection_table();
+  void send_stateless_reset(UDPPacket *udp_packet, const QUICConnectionId &dcid);
+
 protected:
   // QUICPacketHandler
   Continuation *_get_continuation() override;
 
 private:
   void _recv_packet(int event, UDPPacket *udp_packet) override;
+  EThread *_steer(const uint8_t *buf, uint64_t buf_len, const QUICConnectionId &dcid);
   int _stateless_retry(const uint8_t *buf, uint64_t buf_len, UDPConnection *connection, IpEndpoint from, QUICConnectionId dcid,
                        QUICConnectionId scid, QUICConnectionId *original_cid);
 
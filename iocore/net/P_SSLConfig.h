@@ -113,6 +113,7 @@ struct SSLConfigParams : public ConfigInfo {
   static size_t session_cache_number_buckets;
   static size_t session_cache_max_bucket_size;
   static bool session_cache_skip_on_lock_contention;
+  static char *session_cache_shm_path;
 
   static IpMap *proxy_protocol_ipmap;
 
@@ -121,6 +122,9 @@ struct SSLConfigParams : public ConfigInfo {
 
   static int async_handshake_enabled;
   static char *engine_conf_file;
+  static char *async_batch_engine;
+  static char *async_batch_flush_cmd;
+  static int async_batch_size;
 
   shared_SSL_CTX client_ctx;
 
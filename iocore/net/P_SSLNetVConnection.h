@@ -119,6 +119,9 @@ public:
     return sslHandshakeStatus != SSL_HANDSHAKE_ONGOING;
   }
 
+  /// Only a blind tunnel has plain bytes on the socket.
+  bool is_spliceable() const override;
+
   virtual void
   setSSLHandShakeComplete(enum SSLHandshakeStatus state)
   {
@@ -422,6 +425,8 @@ private:
   enum SSLHandshakeStatus sslHandshakeStatus = SSL_HANDSHAKE_ONGOING;
   bool sslClientRenegotiationAbort           = false;
   bool sslSessionCacheHit                    = false;
+  bool sslKTLSSend                           = false; ///< Kernel TLS does the transmit encryption.
+  bool sslAsyncBatched                       = false; ///< Handshake is paused on the async batching engine.
   MIOBuffer *handShakeBuffer                 = nullptr;
   IOBufferReader *handShakeHolder            = nullptr;
   IOBufferReader *handShakeReader            = nullptr;
@@ -34,6 +34,9 @@
 #include "records/I_RecCore.h"
 #include "P_SSLCertLookup.h"
 
+#include <unordered_map>
+#include <vector>
+
 struct SSLConfigParams;
 class SSLNetVConnection;
 
@@ -61,11 +64,27 @@ public:
   static bool index_certificate(SSLCertLookup *lookup, SSLCertContext const &cc, X509 *cert, const char *certname);
   static int check_server_cert_now(X509 *cert, const char *certname);
   static void clear_pw_references(SSL_CTX *ssl_ctx);
+  /// Call SSLConfigParams::init_ssl_ctx_cb for a server context. Contexts built on the worker
+  /// threads of load() are passed to the hooks later, on the loading thread.
+  static void run_init_ssl_ctx_cb(SSL_CTX *ctx);
 
 protected:
   const SSLConfigParams *_params;
 
+  /// Get the context built by load() ahead of time for @a sslMultCertSettings, or build it now.
+  SSL_CTX *_take_server_ssl_ctx(std::vector<X509 *> &certList, const SSLMultiCertConfigParams *sslMultCertSettings);
+
 private:
+  /// A server context built ahead of indexing.
+  struct PreparedCtx {
+    SSL_CTX *ctx = nullptr;
+    std::vector<X509 *> cert_list;
+  };
+
+  void _prepare_ssl_ctxs(const std::vector<shared_SSLMultiCertConfigParams> &entries, int nthreads, unsigned elevate);
+
+  std::unordered_map<const SSLMultiCertConfigParams *, PreparedCtx> _prepared;
+
   virtual SSL_CTX *_store_ssl_ctx(SSLCertLookup *lookup, const shared_SSLMultiCertConfigParams ssl_multi_cert_params);
   virtual void _set_handshake_callbacks(SSL_CTX *ctx);
 };
@@ -86,6 +105,15 @@ void SSLInitializeLibrary();
 // Initialize SSL library based on configuration settings
 void SSLPostConfigInitialize();
 
+// Batch async crypto operations from handshakes on the calling thread, see
+// proxy.config.ssl.async.batch.engine. SSLAsyncBatchAdd() notes that a handshake is paused on
+// the engine and returns whether it is tracked, SSLAsyncBatchDone() must then be called when that
+// handshake resumes or goes away. SSLAsyncBatchFlush() hands everything collected so far to the
+// engine and keeps polling it until the tracked handshakes are done.
+bool SSLAsyncBatchAdd();
+void SSLAsyncBatchDone();
+void SSLAsyncBatchFlush();
+
 // Wrapper functions to SSL I/O routines
 ssl_error_t SSLWriteBuffer(SSL *ssl, const void *buf, int64_t nbytes, int64_t &nwritten);
 ssl_error_t SSLReadBuffer(SSL *ssl, void *buf, int64_t nbytes, int64_t &nread);
@@ -0,0 +1,120 @@
+/** @file
+
+  Kernel splice() tunnel between two net connections.
+
+  @section license License
+
+  Licensed to the Apache Software Foundation (ASF) under one
+  or more contributor license agreements.  See the NOTICE file
+  distributed with this work for additional information
+  regarding copyright ownership.  The ASF licenses this file
+  to you under the Apache License, Version 2.0 (the
+  "License"); you may not use this file except in compliance
+  with the License.  You may obtain a copy of the License at
+
+      http://www.apache.org/licenses/LICENSE-2.0
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+ */
+
+#pragma once
+
+#include "I_EventSystem.h"
+
+class NetHandler;
+class NetVConnection;
+class UnixNetVConnection;
+class SpliceTunnel;
+
+/** One direction of a @c SpliceTunnel.
+
+    Bytes are spliced from the socket of @a src into a pipe and from the pipe into the socket of @a dst,
+    without being copied to user space. The channel is hung off @c NetState::splice of the read side of
+    @a src and the write side of @a dst, so the @c NetHandler drives it from the normal poll loop.
+ */
+struct NetSplice {
+  SpliceTunnel *tunnel    = nullptr;
+  UnixNetVConnection *src = nullptr;
+  UnixNetVConnection *dst = nullptr;
+  /// Bytes read before the tunnel started, written to @a dst with a normal VIO before splicing.
+  IOBufferReader *prefix = nullptr;
+  int pipe_fd[2]         = {-1, -1};
+  int64_t pipe_size      = 0;
+  int64_t in_pipe        = 0; ///< Bytes in the pipe not yet written to @a dst.
+  int64_t bytes_read     = 0; ///< Bytes read from @a src, not counting @a prefix.
+  int64_t bytes_written  = 0; ///< Bytes written to @a dst, including @a prefix.
+  bool eos               = false;
+  bool done              = false;
+
+  /// Called by the @c NetHandler when the socket of @a src is readable.
+  void read_from_net(NetHandler *nh);
+  /// Called by the @c NetHandler when the socket of @a dst is writable.
+  void write_to_net(NetHandler *nh);
+
+private:
+  bool drain(NetHandler *nh);
+  void stop_reading(NetHandler *nh);
+};
+
+/** Move bytes in both directions between two connections with splice(2).
+
+    This is the zero copy replacement for a blind tunnel: nothing is inspected or transformed, the
+    bytes never enter an @c MIOBuffer. Both connections must be plain sockets (or TLS connections that
+    were switched to blind tunnel mode) owned by the current thread, see @c can_splice.
+
+    The tunnel runs under the mutex of its owner. Once both directions have finished, or one of the
+    connections failed or timed out, the owner is called back with @c NET_EVENT_SPLICE_DONE and the
+    tunnel as data. The owner must then read the byte counts, call @c destroy and close the connections;
+    the tunnel never closes them itself.
+ */
+class SpliceTunnel : public Continuation
+{
+public:
+  enum Direction { A_TO_B, B_TO_A };
+
+  /// Whether @a a and @a b can be tunneled with splice.
+  static bool can_splice(NetVConnection *a, NetVConnection *b);
+
+  /** Start tunneling between @a a and @a b.
+
+      @a a_to_b and @a b_to_a hold bytes already read from @a a and @a b respectively, they are sent
+      before anything is spliced in that direction. Either may be @c nullptr.
+
+      @return The tunnel, or @c nullptr if it could not be set up (e.g. out of file descriptors), in
+      which case nothing has been changed on either connection.
+   */
+  static SpliceTunnel *start(Continuation *owner, NetVConnection *a, NetVConnection *b, IOBufferReader *a_to_b,
+                             IOBufferReader *b_to_a);
+
+  /// Detach from both connections and free the tunnel.
+  void destroy();
+
+  const NetSplice &
+  channel(Direction d) const
+  {
+    return _channel[d];
+  }
+
+  /// Set if the tunnel stopped because of an error or timeout rather than both sides closing.
+  int error_event = 0;
+
+  SpliceTunnel();
+
+private:
+  friend struct NetSplice;
+
+  int main_event(int event, void *data);
+  void start_splice(NetSplice &ch);
+  void finish_channel(NetSplice &ch);
+  void fail(int event, int lerrno = 0);
+  void signal_done();
+
+  Continuation *_owner = nullptr;
+  NetSplice _channel[2];
+  Event *_done_event = nullptr;
+  bool _signalled    = false;
+};
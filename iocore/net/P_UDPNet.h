@@ -287,6 +287,9 @@ public:
 
   void SendPackets();
   void SendUDPPacket(UDPPacketInternal *p, int32_t pktLen);
+  void SendMultipleUDPPackets(UDPPacketInternal **packets, int n);
+
+  static constexpr int N_MAX_PACKETS = 64;
 
   // Interface exported to the outside world
   void send(UDPPacket *p);
@@ -40,7 +40,13 @@
 #if TS_USE_EPOLL
 #ifdef USE_EDGE_TRIGGER_EPOLL
 #define USE_EDGE_TRIGGER 1
+#ifdef EPOLLRDHUP
+// Knowing about a pending peer shutdown lets read_from_net() trust a short read to have drained the socket.
+#define EVENTIO_HANGUP EPOLLRDHUP
+#define EVENTIO_READ (EPOLLIN | EPOLLRDHUP | EPOLLET)
+#else
 #define EVENTIO_READ (EPOLLIN | EPOLLET)
+#endif
 #define EVENTIO_WRITE (EPOLLOUT | EPOLLET)
 #else
 #define EVENTIO_READ EPOLLIN
@@ -125,6 +131,7 @@ extern ink_hrtime last_shedding_warning;
 extern ink_hrtime emergency_throttle_time;
 extern int net_connections_throttle;
 extern bool net_memory_throttle;
+extern int net_memory_usage_pct;
 extern int fds_throttle;
 extern int fds_limit;
 extern ink_hrtime last_transient_accept_error;
@@ -252,6 +259,9 @@ public:
     uint32_t transaction_no_activity_timeout_in = 0;
     uint32_t keep_alive_no_activity_timeout_in  = 0;
     uint32_t default_inactivity_timeout         = 0;
+    uint32_t keep_alive_shed_threshold          = 0;
+    uint32_t keep_alive_shed_min_timeout        = 0;
+    uint32_t max_io_per_loop                    = 0;
 
     /** Return the address of the first value in this struct.
 
@@ -274,6 +284,12 @@ public:
   // These are never updated directly, they are computed from other config values.
   uint32_t max_connections_per_thread_in        = 0;
   uint32_t max_connections_active_per_thread_in = 0;
+
+  /// Why idle connections were closed before their keep-alive timeout.
+  enum ShedReason { SHED_MAX_CONNECTIONS, SHED_FD_PRESSURE, SHED_MEMORY_PRESSURE };
+  /// Resource pressure (percent of the fd or memory limit, whichever is higher) as of the last InactivityCop run.
+  int pressure = 0;
+  ShedReason pressure_reason = SHED_FD_PRESSURE;
   /// Number of configuration items in @c Config.
   static constexpr int CONFIG_ITEM_COUNT = sizeof(Config) / sizeof(uint32_t);
   /// Which members of @c Config the per thread values depend on.
@@ -290,6 +306,8 @@ public:
   void process_ready_list();
   void manage_keep_alive_queue();
   bool manage_active_queue(bool ignore_queue_size);
+  void update_pressure();
+  void shed_keep_alive_queue();
   void add_to_keep_alive_queue(UnixNetVConnection *vc);
   void remove_from_keep_alive_queue(UnixNetVConnection *vc);
   bool add_to_active_queue(UnixNetVConnection *vc);
@@ -351,7 +369,7 @@ public:
   NetHandler();
 
 private:
-  void _close_vc(UnixNetVConnection *vc, ink_hrtime now, int &handle_event, int &closed, int &total_idle_time,
+  bool _close_vc(UnixNetVConnection *vc, ink_hrtime now, int &handle_event, int &closed, int &total_idle_time,
                  int &total_idle_count);
 
   /// Static method used as the callback for runtime configuration updates.
@@ -404,6 +422,17 @@ check_shedding_warning()
   }
 }
 
+TS_INLINE void
+check_pressure_shedding_warning(NetHandler::ShedReason reason, int pressure)
+{
+  ink_hrtime t = Thread::get_hrtime();
+  if (t - last_shedding_warning > NET_THROTTLE_MESSAGE_EVERY) {
+    last_shedding_warning = t;
+    RecSignalWarning(REC_SIGNAL_SYSTEM_ERROR, "shedding idle connections, %s usage at %d%% of limit",
+                     reason == NetHandler::SHED_MEMORY_PRESSURE ? "memory" : "file descriptor", pressure);
+  }
+}
+
 TS_INLINE bool
 check_net_throttle(ThrottleType t)
 {
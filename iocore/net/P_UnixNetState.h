@@ -41,6 +41,7 @@
 
 class Event;
 class UnixNetVConnection;
+struct NetSplice;
 
 struct NetState {
   int enabled = 0;
@@ -49,6 +50,9 @@ struct NetState {
   SLink<UnixNetVConnection> enable_link;
   int in_enabled_list = 0;
   int triggered       = 0;
+  int hangup          = 0; ///< The last poll reported a peer shutdown or an error.
+  /// Set while this side is driven by a @c SpliceTunnel instead of the VIO buffer.
+  NetSplice *splice = nullptr;
 
   NetState() : vio(VIO::NONE) {}
 };
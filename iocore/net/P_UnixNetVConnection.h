@@ -103,6 +103,16 @@ struct OOB_callback : public Continuation {
 
 enum tcp_congestion_control_t { CLIENT_SIDE, SERVER_SIDE };
 
+/// State for sizing writes from TCP_INFO samples, see @c UnixNetVConnection::tcp_write_budget.
+struct TcpWriteSizing {
+  ink_hrtime next_sample = 0;     ///< Sample again at this time, about once per round trip.
+  int64_t target         = 0;     ///< Unsent bytes to keep in the kernel, the estimated bandwidth delay product.
+  int64_t unsent         = 0;     ///< Unsent bytes at the last sample, plus those written since.
+  int64_t mss            = 0;     ///< Smallest write handed to the kernel.
+  int lowat              = 0;     ///< TCP_NOTSENT_LOWAT currently set on the socket.
+  bool unavailable       = false; ///< TCP_INFO did not work for this socket.
+};
+
 class UnixNetVConnection : public NetVConnection
 {
 public:
@@ -215,6 +225,13 @@ public:
     return false;
   }
 
+  /// Whether the socket carries the stream as is, so a @c SpliceTunnel can move it.
+  virtual bool
+  is_spliceable() const
+  {
+    return con.fd != NO_FD && !closed && f.shutdown == 0;
+  }
+
   virtual void net_read_io(NetHandler *nh, EThread *lthread);
   virtual int64_t load_buffer_and_write(int64_t towrite, MIOBufferAccessor &buf, int64_t &total_written, int &needs);
   void readDisable(NetHandler *nh);
@@ -269,6 +286,17 @@ public:
   OOB_callback *oob_ptr    = nullptr;
   bool from_accept_thread  = false;
   NetAccept *accept_object = nullptr;
+  TcpWriteSizing tcp_sizing;
+
+  /** Bytes the socket can take now without queueing much more than it drains in a round trip.
+
+      Samples TCP_INFO at most once per round trip and keeps TCP_NOTSENT_LOWAT of the socket at the
+      estimated bandwidth delay product, so the kernel signals write ready once the queue has
+      drained to that level.
+
+      @return The budget, or -1 if TCP_INFO is not available.
+   */
+  int64_t tcp_write_budget();
 
   // es - origin_trace associated connections
   bool origin_trace;
@@ -171,9 +171,7 @@ QUICMultiCertConfigLoader::init_server_ssl_ctx(std::vector<X509 *> &cert_list, c
   }
 #endif /* TS_USE_TLS_OCSP */
 
-  if (SSLConfigParams::init_ssl_ctx_cb) {
-    SSLConfigParams::init_ssl_ctx_cb(ctx, true);
-  }
+  SSLMultiCertConfigLoader::run_init_ssl_ctx_cb(ctx);
 
   return ctx;
 
@@ -190,7 +188,7 @@ SSL_CTX *
 QUICMultiCertConfigLoader::_store_ssl_ctx(SSLCertLookup *lookup, const shared_SSLMultiCertConfigParams multi_cert_params)
 {
   std::vector<X509 *> cert_list;
-  shared_SSL_CTX ctx(this->init_server_ssl_ctx(cert_list, multi_cert_params.get()), SSL_CTX_free);
+  shared_SSL_CTX ctx(this->_take_server_ssl_ctx(cert_list, multi_cert_params.get()), SSL_CTX_free);
   shared_ssl_ticket_key_block keyblock = nullptr;
   bool inserted                        = false;
 
@@ -243,9 +241,7 @@ QUICMultiCertConfigLoader::_store_ssl_ctx(SSLCertLookup *lookup, const shared_SS
   }
 
   if (inserted) {
-    if (SSLConfigParams::init_ssl_ctx_cb) {
-      SSLConfigParams::init_ssl_ctx_cb(ctx.get(), true);
-    }
+    SSLMultiCertConfigLoader::run_init_ssl_ctx_cb(ctx.get());
   }
 
   if (!inserted) {
@@ -29,8 +29,9 @@ ClassAllocator<QUICPollEvent> quicPollEventAllocator("quicPollEvent");
 void
 QUICPollEvent::init(QUICConnection *con, UDPPacketInternal *packet)
 {
-  this->con    = con;
-  this->packet = packet;
+  this->con     = con;
+  this->packet  = packet;
+  this->handler = nullptr;
   if (con != nullptr) {
     static_cast<QUICNetVConnection *>(con)->refcount_inc();
   }
@@ -59,6 +60,74 @@ QUICPollCont::QUICPollCont(Ptr<ProxyMutex> &m, NetHandler *nh) : Continuation(m.
 
 QUICPollCont::~QUICPollCont() {}
 
+// Find the connection for a packet that was steered to this thread by its connection ID. Returns
+// false if the packet was consumed.
+bool
+QUICPollCont::_resolve_steered_packet(QUICPollEvent *e)
+{
+  UDPPacketInternal *p  = e->packet;
+  IOBufferBlock *block  = p->getIOBlockChain();
+  QUICConnectionId dcid = QUICConnectionId::ZERO();
+
+  const uint8_t *buf    = reinterpret_cast<uint8_t *>(block->buf());
+
+  QUICInvariants::dcid(dcid, buf, block->size());
+
+  QUICNetVConnection *vc = this->_find_connection(dcid, e->handler->connection_table());
+  if (vc == nullptr || vc->in_closed_queue) {
+    // Same as QUICPacketHandlerIn::_recv_packet(), a stray Handshake packet is just dropped.
+    if (vc != nullptr || !QUICInvariants::is_long_header(buf)) {
+      e->handler->send_stateless_reset(p, dcid);
+    }
+    p->free();
+    e->free();
+    return false;
+  }
+
+  if (vc->thread != this->mutex->thread_holding) {
+    // The ID was not issued by this thread after all, pass the packet on like an unsteered one.
+    QUICPollEvent *qe = quicPollEventAllocator.alloc();
+    qe->init(vc, p);
+    get_QUICPollCont(vc->thread)->inQueue.push(qe);
+    get_NetHandler(vc->thread)->signalActivity();
+    e->free();
+    return false;
+  }
+
+  e->init(vc, p);
+  return true;
+}
+
+QUICNetVConnection *
+QUICPollCont::_find_connection(const QUICConnectionId &cid, QUICConnectionTable &ctable)
+{
+  auto spot = this->_connections.find(cid);
+  if (spot != this->_connections.end()) {
+    return spot->second;
+  }
+
+  QUICNetVConnection *vc = static_cast<QUICNetVConnection *>(ctable.lookup(cid));
+  if (vc != nullptr && !vc->in_closed_queue) {
+    vc->refcount_inc();
+    this->_connections.emplace(cid, vc);
+  }
+  return vc;
+}
+
+// Drop the references to closed connections so the collector can free them.
+void
+QUICPollCont::_sweep_connections()
+{
+  for (auto spot = this->_connections.begin(); spot != this->_connections.end();) {
+    if (spot->second->in_closed_queue) {
+      spot->second->refcount_dec();
+      spot = this->_connections.erase(spot);
+    } else {
+      ++spot;
+    }
+  }
+}
+
 void
 QUICPollCont::_process_long_header_packet(QUICPollEvent *e, NetHandler *nh)
 {
@@ -135,6 +204,10 @@ QUICPollCont::pollEvent(int, Event *)
   SList(QUICPollEvent, alink) aq(inQueue.popall());
   Queue<QUICPollEvent> result;
   while ((e = aq.pop())) {
+    if (e->handler != nullptr && !this->_resolve_steered_packet(e)) {
+      continue;
+    }
+
     QUICNetVConnection *qvc = static_cast<QUICNetVConnection *>(e->con);
     UDPPacketInternal *p    = e->packet;
     if (qvc != nullptr && qvc->in_closed_queue) {
@@ -156,6 +229,14 @@ QUICPollCont::pollEvent(int, Event *)
     }
   }
 
+  if (!this->_connections.empty()) {
+    ink_hrtime now = Thread::get_hrtime();
+    if (now >= this->_next_sweep) {
+      this->_sweep_connections();
+      this->_next_sweep = now + HRTIME_SECONDS(1);
+    }
+  }
+
   return EVENT_CONT;
 }
 
@@ -167,5 +248,14 @@ initialize_thread_for_quic_net(EThread *thread)
 
   new ((ink_dummy_for_new *)quicpc) QUICPollCont(thread->mutex, nh);
 
+  int index = 0;
+  for (EThread *t : eventProcessor.active_group_threads(ET_NET)) {
+    if (t == thread) {
+      quicpc->owner_tag = index;
+      break;
+    }
+    ++index;
+  }
+
   thread->schedule_every(quicpc, -HRTIME_MSECONDS(UDP_PERIOD));
 }
@@ -214,8 +214,25 @@ QUICNetProcessor::main_accept(Continuation *cont, SOCKET fd, AcceptOptions const
   na->action_->server = &na->server;
   na->init_accept();
 
-  SCOPED_MUTEX_LOCK(lock, na->mutex, this_ethread());
-  udpNet.UDPBind((Continuation *)na, &na->server.accept_addr.sa, 1048576, 1048576);
+  if (listen_per_thread) {
+    // Every UDP thread reads its own SO_REUSEPORT socket through its own packet handler, so the
+    // kernel keeps each peer on one thread and the threads never wait on each other.
+    bool first = true;
+    for (EThread *t : eventProcessor.active_group_threads(ET_UDP)) {
+      NetAccept *a = na;
+      if (!first) {
+        a        = na->clone();
+        a->mutex = new_ProxyMutex();
+      }
+      first = false;
+
+      SCOPED_MUTEX_LOCK(lock, a->mutex, this_ethread());
+      udpNet.UDPBind((Continuation *)a, &na->server.accept_addr.sa, 1048576, 1048576, t);
+    }
+  } else {
+    SCOPED_MUTEX_LOCK(lock, na->mutex, this_ethread());
+    udpNet.UDPBind((Continuation *)na, &na->server.accept_addr.sa, 1048576, 1048576);
+  }
 
   return na->action_.get();
 }
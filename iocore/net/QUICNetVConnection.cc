@@ -303,6 +303,9 @@ QUICNetVConnection::init(QUICConnectionId peer_cid, QUICConnectionId original_ci
   this->_original_quic_connection_id = original_cid;
   this->_first_quic_connection_id    = first_cid;
   this->_quic_connection_id.randomize();
+  if (listen_per_thread && this->thread != nullptr) {
+    this->_quic_connection_id.set_owner_tag(get_QUICPollCont(this->thread)->owner_tag);
+  }
 
   if (ctable) {
     this->_ctable = ctable;
@@ -195,6 +195,42 @@ QUICPacketHandlerIn::_get_continuation()
   return static_cast<NetAccept *>(this);
 }
 
+QUICConnectionTable &
+QUICPacketHandlerIn::connection_table()
+{
+  return this->_ctable;
+}
+
+void
+QUICPacketHandlerIn::send_stateless_reset(UDPPacket *udp_packet, const QUICConnectionId &dcid)
+{
+  QUICConfig::scoped_config params;
+  QUICStatelessResetToken token(dcid, params->instance_id());
+  auto packet = QUICPacketFactory::create_stateless_reset_packet(dcid, token);
+  this->_send_packet(*packet, udp_packet->getConnection(), udp_packet->from, 1200, nullptr, 0);
+}
+
+// With per thread listening the connection IDs we issue name the ET_NET thread that owns the
+// connection. Packets that must carry one of them (everything but Initial and 0-RTT) go straight to
+// that thread, which looks the connection up itself.
+EThread *
+QUICPacketHandlerIn::_steer(const uint8_t *buf, uint64_t buf_len, const QUICConnectionId &dcid)
+{
+  if (!listen_per_thread) {
+    return nullptr;
+  }
+
+  if (QUICInvariants::is_long_header(buf)) {
+    QUICPacketType type = QUICPacketType::UNINITIALIZED;
+    QUICPacketLongHeader::type(type, buf, buf_len);
+    if (type != QUICPacketType::HANDSHAKE) {
+      return nullptr;
+    }
+  }
+
+  return get_QUICOwnerThread(dcid.owner_tag());
+}
+
 void
 QUICPacketHandlerIn::_recv_packet(int event, UDPPacket *udp_packet)
 {
@@ -277,6 +313,15 @@ QUICPacketHandlerIn::_recv_packet(int event, UDPPacket *udp_packet)
     }
   }
 
+  if (EThread *owner = this->_steer(buf, buf_len, dcid)) {
+    QUICPollEvent *qe = quicPollEventAllocator.alloc();
+    qe->init(nullptr, static_cast<UDPPacketInternal *>(udp_packet));
+    qe->handler = this;
+    get_QUICPollCont(owner)->inQueue.push(qe);
+    get_NetHandler(owner)->signalActivity();
+    return;
+  }
+
   QUICConnection *qc     = this->_ctable.lookup(dcid);
   QUICNetVConnection *vc = static_cast<QUICNetVConnection *>(qc);
 
@@ -306,9 +351,7 @@ QUICPacketHandlerIn::_recv_packet(int event, UDPPacket *udp_packet)
       }
     }
 
-    QUICStatelessResetToken token(dcid, params->instance_id());
-    auto packet = QUICPacketFactory::create_stateless_reset_packet(dcid, token);
-    this->_send_packet(*packet, udp_packet->getConnection(), udp_packet->from, 1200, nullptr, 0);
+    this->send_stateless_reset(udp_packet, dcid);
     udp_packet->free();
     return;
   }
@@ -329,12 +372,12 @@ QUICPacketHandlerIn::_recv_packet(int event, UDPPacket *udp_packet)
       QUICDebugDS(peer_cid, original_cid, "client initial dcid=%s", client_dcid_hex_str);
     }
 
-    vc = static_cast<QUICNetVConnection *>(getNetProcessor()->allocate_vc(nullptr));
+    vc         = static_cast<QUICNetVConnection *>(getNetProcessor()->allocate_vc(nullptr));
+    vc->thread = eth; // init() puts the owner thread into the connection ID
     vc->init(peer_cid, original_cid, cid_in_retry_token, udp_packet->getConnection(), this, &this->_ctable);
     vc->id = net_next_connection_number();
     vc->con.move(con);
     vc->submit_time = Thread::get_hrtime();
-    vc->thread      = eth;
     vc->mutex       = new_ProxyMutex();
     vc->action_     = *this->action_;
     vc->set_is_transparent(this->opt.f_inbound_transparent);
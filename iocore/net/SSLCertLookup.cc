@@ -38,7 +38,6 @@
 #include "P_SSLConfig.h"
 #include "SSLSessionTicket.h"
 
-#include <unordered_map>
 #include <vector>
 #include <algorithm>
 
@@ -79,6 +78,60 @@ private:
   unsigned char sep = 0; // offset of address/port separator
 };
 
+/** Host names indexed by their labels in reverse order.
+
+    "www.example.com" is stored as the path com -> example -> www. Each node carries the context
+    index for the exact name it spells and for the wildcard one level below it, so "*.example.com"
+    lives on the "example" node. Names sharing a suffix share nodes, all label text is kept in a
+    single arena and children are found through one open addressed table keyed by (parent, label),
+    so a lookup costs one probe per label and never allocates.
+
+    All names must be lower case.
+*/
+class SSLNameTrie
+{
+public:
+  SSLNameTrie();
+
+  /// Create the path for @a name if needed.
+  /// @return The exact index slot for @a name, or the wildcard slot if @a wildcard is set. The
+  /// pointer is only valid until the next call to @c slot.
+  int *slot(std::string_view name, bool wildcard);
+
+  /// Find the index for @a name, an exact match has priority over a wildcard for the parent domain.
+  /// @return The context index or -1 if there is no match.
+  int find(std::string_view name) const;
+
+  /// Call @a f with the domain and index of each wildcard.
+  template <typename F> void for_each_wildcard(F &&f) const;
+
+private:
+  static constexpr uint32_t ROOT = 0; ///< The root node, also "no node" since it is never a child.
+
+  struct Node {
+    uint32_t parent;    ///< Parent node.
+    uint32_t label;     ///< Offset of the label in @a _labels.
+    uint32_t label_len; ///< Length of the label.
+    int exact = -1;     ///< Context index for the name spelled by this node.
+    int wild  = -1;     ///< Context index for "*." followed by the name spelled by this node.
+  };
+
+  std::string_view
+  label(Node const &n) const
+  {
+    return {_labels.data() + n.label, n.label_len};
+  }
+
+  static size_t hash(uint32_t parent, std::string_view label);
+  uint32_t find_child(uint32_t parent, std::string_view label) const;
+  uint32_t add_child(uint32_t parent, std::string_view label);
+  void index_node(uint32_t n);
+
+  std::vector<Node> _nodes;    ///< All nodes, the root first.
+  std::string _labels;         ///< Label arena.
+  std::vector<uint32_t> _kids; ///< Child table, @c ROOT marks an empty bucket. Size is a power of 2.
+};
+
 struct SSLContextStorage {
 public:
   SSLContextStorage();
@@ -124,11 +177,9 @@ private:
     LINK(ContextRef, link); ///< Require by @c Trie
   };
 
-  /// We can only match one layer with the wildcards
-  /// This table stores the wildcarded subdomain
-  std::unordered_map<std::string, int> wilddomains;
-  /// Contexts stored by IP address or FQDN
-  std::unordered_map<std::string, int> hostnames;
+  /// Contexts stored by IP address or FQDN, and wildcarded subdomains.
+  /// We can only match one layer with the wildcards.
+  SSLNameTrie names;
   /// List for cleanup.
   /// Exactly one pointer to each SSL context is stored here.
   std::vector<SSLCertContext> ctx_store;
@@ -362,6 +413,120 @@ SSLContextStorage::insert(const char *name, SSLCertContext const &cc)
   return idx;
 }
 
+SSLNameTrie::SSLNameTrie() : _nodes(1, Node{ROOT, 0, 0}), _kids(16, ROOT) {}
+
+size_t
+SSLNameTrie::hash(uint32_t parent, std::string_view label)
+{
+  return std::hash<std::string_view>{}(label) ^ (parent * 0x9E3779B97F4A7C15ULL);
+}
+
+uint32_t
+SSLNameTrie::find_child(uint32_t parent, std::string_view label) const
+{
+  size_t mask = _kids.size() - 1;
+
+  for (size_t i = hash(parent, label) & mask;; i = (i + 1) & mask) {
+    uint32_t n = _kids[i];
+    if (n == ROOT || (_nodes[n].parent == parent && this->label(_nodes[n]) == label)) {
+      return n;
+    }
+  }
+}
+
+void
+SSLNameTrie::index_node(uint32_t n)
+{
+  size_t mask = _kids.size() - 1;
+  size_t i    = hash(_nodes[n].parent, label(_nodes[n])) & mask;
+
+  while (_kids[i] != ROOT) {
+    i = (i + 1) & mask;
+  }
+  _kids[i] = n;
+}
+
+uint32_t
+SSLNameTrie::add_child(uint32_t parent, std::string_view label)
+{
+  uint32_t n = _nodes.size();
+
+  _nodes.push_back(Node{parent, static_cast<uint32_t>(_labels.size()), static_cast<uint32_t>(label.size())});
+  _labels.append(label);
+
+  // Keep the table at most half full.
+  if (_nodes.size() * 2 > _kids.size()) {
+    _kids.assign(_kids.size() * 2, ROOT);
+    for (uint32_t k = 1; k < _nodes.size(); ++k) {
+      this->index_node(k);
+    }
+  } else {
+    this->index_node(n);
+  }
+  return n;
+}
+
+int *
+SSLNameTrie::slot(std::string_view name, bool wildcard)
+{
+  uint32_t node = ROOT;
+
+  for (;;) {
+    auto dot               = name.rfind('.');
+    std::string_view label = dot == std::string_view::npos ? name : name.substr(dot + 1);
+    uint32_t child         = this->find_child(node, label);
+
+    node = child != ROOT ? child : this->add_child(node, label);
+    if (dot == std::string_view::npos) {
+      break;
+    }
+    name.remove_suffix(name.size() - dot);
+  }
+  return wildcard ? &_nodes[node].wild : &_nodes[node].exact;
+}
+
+int
+SSLNameTrie::find(std::string_view name) const
+{
+  uint32_t node = ROOT;
+
+  for (;;) {
+    auto dot = name.rfind('.');
+    if (dot == std::string_view::npos) {
+      // @a node spells the name without its first label, which is where a matching wildcard is.
+      if (uint32_t leaf = this->find_child(node, name); leaf != ROOT && _nodes[leaf].exact >= 0) {
+        return _nodes[leaf].exact;
+      }
+      return _nodes[node].wild;
+    }
+    if ((node = this->find_child(node, name.substr(dot + 1))) == ROOT) {
+      return -1;
+    }
+    name.remove_suffix(name.size() - dot);
+  }
+}
+
+template <typename F>
+void
+SSLNameTrie::for_each_wildcard(F &&f) const
+{
+  std::string domain;
+
+  for (uint32_t n = 1; n < _nodes.size(); ++n) {
+    if (_nodes[n].wild < 0) {
+      continue;
+    }
+    domain.clear();
+    for (uint32_t k = n; k != ROOT; k = _nodes[k].parent) {
+      if (!domain.empty()) {
+        domain += '.';
+      }
+      domain += label(_nodes[k]);
+    }
+    f(domain, _nodes[n].wild);
+  }
+}
+
 int
 SSLContextStorage::insert(const char *name, int idx)
 {
@@ -379,22 +544,20 @@ SSLContextStorage::insert(const char *name, int idx)
       subdomain = nullptr;
     }
     if (subdomain) {
-      if (auto it = this->wilddomains.find(subdomain); it != this->wilddomains.end()) {
-        Debug("ssl", "previously indexed '%s' with SSL_CTX #%d, cannot index it with SSL_CTX #%d now", lower_case_name, it->second,
-              idx);
+      if (int *slot = this->names.slot(subdomain, true); *slot >= 0) {
+        Debug("ssl", "previously indexed '%s' with SSL_CTX #%d, cannot index it with SSL_CTX #%d now", lower_case_name, *slot, idx);
         idx = -1;
       } else {
-        this->wilddomains.emplace(subdomain, idx);
+        *slot = idx;
         Debug("ssl", "indexed '%s' with SSL_CTX %p [%d]", lower_case_name, ctx.get(), idx);
       }
     }
   } else {
-    if (auto it = this->hostnames.find(lower_case_name); it != this->hostnames.end() && idx != it->second) {
-      Debug("ssl", "previously indexed '%s' with SSL_CTX %d, cannot index it with SSL_CTX #%d now", lower_case_name, it->second,
-            idx);
+    if (int *slot = this->names.slot(lower_case_name, false); *slot >= 0 && idx != *slot) {
+      Debug("ssl", "previously indexed '%s' with SSL_CTX %d, cannot index it with SSL_CTX #%d now", lower_case_name, *slot, idx);
       idx = -1;
     } else {
-      this->hostnames.emplace(lower_case_name, idx);
+      *slot = idx;
       Debug("ssl", "indexed '%s' with SSL_CTX %p [%d]", lower_case_name, ctx.get(), idx);
     }
   }
@@ -404,34 +567,18 @@ SSLContextStorage::insert(const char *name, int idx)
 void
 SSLContextStorage::printWildDomains() const
 {
-  for (auto &&it : this->wilddomains) {
-    Debug("ssl", "Stored wilddomain %s", it.first.c_str());
-  }
+  this->names.for_each_wildcard([](std::string const &domain, int) { Debug("ssl", "Stored wilddomain %s", domain.c_str()); });
 }
 
 SSLCertContext *
 SSLContextStorage::lookup(const char *name)
 {
-  // First look for an exact name match
-  if (auto it = this->hostnames.find(name); it != this->hostnames.end()) {
-    return &(this->ctx_store[it->second]);
-  }
-  // Try lower casing it
   char lower_case_name[TS_MAX_HOST_NAME_LEN + 1];
   transform_lower(name, lower_case_name);
-  if (auto it_lower = this->hostnames.find(lower_case_name); it_lower != this->hostnames.end()) {
-    return &(this->ctx_store[it_lower->second]);
-  }
 
-  // Then strip off the top domain name and look for a wildcard domain match
-  const char *subdomain = index(lower_case_name, '.');
-  if (subdomain) {
-    ++subdomain; // Move beyond the '.'
-    if (auto it = this->wilddomains.find(subdomain); it != this->wilddomains.end()) {
-      return &(this->ctx_store[it->second]);
-    }
-  }
-  return nullptr;
+  // Exact matches win over a wildcard for the domain with the first label stripped.
+  int idx = this->names.find(lower_case_name);
+  return idx < 0 ? nullptr : &(this->ctx_store[idx]);
 }
 
 #if TS_HAS_TESTS
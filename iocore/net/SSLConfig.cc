@@ -62,12 +62,16 @@ int SSLConfigParams::ssl_handshake_timeout_in               = 0;
 size_t SSLConfigParams::session_cache_number_buckets        = 1024;
 bool SSLConfigParams::session_cache_skip_on_lock_contention = false;
 size_t SSLConfigParams::session_cache_max_bucket_size       = 100;
+char *SSLConfigParams::session_cache_shm_path               = nullptr;
 init_ssl_ctx_func SSLConfigParams::init_ssl_ctx_cb          = nullptr;
 load_ssl_file_func SSLConfigParams::load_ssl_file_cb        = nullptr;
 IpMap *SSLConfigParams::proxy_protocol_ipmap                = nullptr;
 
 int SSLConfigParams::async_handshake_enabled = 0;
 char *SSLConfigParams::engine_conf_file      = nullptr;
+char *SSLConfigParams::async_batch_engine    = nullptr;
+char *SSLConfigParams::async_batch_flush_cmd = nullptr;
+int SSLConfigParams::async_batch_size        = 8;
 
 static std::unique_ptr<ConfigUpdateHandler<SSLCertificateConfig>> sslCertUpdate;
 static std::unique_ptr<ConfigUpdateHandler<SSLConfig>> sslConfigUpdate;
@@ -271,6 +275,15 @@ SSLConfigParams::initialize()
   ssl_ctx_options |= SSL_OP_ALL;
   ssl_client_ctx_options |= SSL_OP_ALL;
 
+#ifdef SSL_OP_ENABLE_KTLS
+  // Let OpenSSL install the session keys into the socket so the kernel does the record encryption.
+  REC_ReadConfigInteger(option, "proxy.config.ssl.ktls.enabled");
+  if (option) {
+    ssl_ctx_options |= SSL_OP_ENABLE_KTLS;
+    ssl_client_ctx_options |= SSL_OP_ENABLE_KTLS;
+  }
+#endif
+
 // According to OpenSSL source, applications must enable this if they support the Server Name extension. Since
 // we do, then we ought to enable this. Httpd also enables this unconditionally.
 #ifdef SSL_OP_NO_SESSION_RESUMPTION_ON_RENEGOTIATION
@@ -308,7 +321,13 @@ SSLConfigParams::initialize()
   SSLConfigParams::session_cache_skip_on_lock_contention = ssl_session_cache_skip_on_contention;
   SSLConfigParams::session_cache_number_buckets          = ssl_session_cache_num_buckets;
 
-  if (ssl_session_cache == SSL_SESSION_CACHE_MODE_SERVER_ATS_IMPL) {
+  ats_free(session_cache_shm_path);
+  REC_ReadConfigStringAlloc(session_cache_shm_path, "proxy.config.ssl.session_cache.shm_path");
+
+  // The session cache settings only change on restart. Net threads use the cache without holding a
+  // reference to this configuration, and a shared mapping must never be set up again while it is in
+  // use, so the cache is created once and kept across reloads.
+  if (ssl_session_cache == SSL_SESSION_CACHE_MODE_SERVER_ATS_IMPL && session_cache == nullptr) {
     session_cache = new SSLSessionCache();
   }
 
@@ -326,6 +345,9 @@ SSLConfigParams::initialize()
 
   REC_ReadConfigInt32(async_handshake_enabled, "proxy.config.ssl.async.handshake.enabled");
   REC_ReadConfigStringAlloc(engine_conf_file, "proxy.config.ssl.engine.conf_file");
+  REC_ReadConfigStringAlloc(async_batch_engine, "proxy.config.ssl.async.batch.engine");
+  REC_ReadConfigStringAlloc(async_batch_flush_cmd, "proxy.config.ssl.async.batch.flush_cmd");
+  REC_ReadConfigInt32(async_batch_size, "proxy.config.ssl.async.batch.size");
 
   REC_ReadConfigStringAlloc(server_groups_list, "proxy.config.ssl.server.groups_list");
 
@@ -160,20 +160,32 @@ make_ssl_connection(SSL_CTX *ctx, SSLNetVConnection *netvc)
   if (likely(ssl = SSL_new(ctx))) {
     netvc->ssl = ssl;
 
+    // OpenSSL only hands the session keys to the kernel through a socket BIO.
+    bool ktls = false;
+#ifdef SSL_OP_ENABLE_KTLS
+    ktls = (SSL_CTX_get_options(ctx) & SSL_OP_ENABLE_KTLS) != 0;
+#endif
+
     // Only set up the bio stuff for the server side
     if (netvc->get_context() == NET_VCONNECTION_OUT) {
-      BIO *bio = BIO_new(const_cast<BIO_METHOD *>(BIO_s_fastopen()));
-      BIO_set_fd(bio, netvc->get_socket(), BIO_NOCLOSE);
+      BIO *bio;
+
+      if (ktls && !netvc->options.f_tcp_fastopen) {
+        bio = BIO_new_socket(netvc->get_socket(), BIO_NOCLOSE);
+      } else {
+        bio = BIO_new(const_cast<BIO_METHOD *>(BIO_s_fastopen()));
+        BIO_set_fd(bio, netvc->get_socket(), BIO_NOCLOSE);
 
-      if (netvc->options.f_tcp_fastopen) {
-        BIO_set_conn_address(bio, netvc->get_remote_addr());
+        if (netvc->options.f_tcp_fastopen) {
+          BIO_set_conn_address(bio, netvc->get_remote_addr());
+        }
       }
 
       SSL_set_bio(ssl, bio, bio);
     } else {
       netvc->initialize_handshake_buffers();
       BIO *rbio = BIO_new(BIO_s_mem());
-      BIO *wbio = BIO_new_fd(netvc->get_socket(), BIO_NOCLOSE);
+      BIO *wbio = ktls ? BIO_new_socket(netvc->get_socket(), BIO_NOCLOSE) : BIO_new_fd(netvc->get_socket(), BIO_NOCLOSE);
       BIO_set_mem_eof_return(wbio, -1);
       SSL_set_bio(ssl, rbio, wbio);
     }
@@ -184,6 +196,27 @@ make_ssl_connection(SSL_CTX *ctx, SSLNetVConnection *netvc)
   return ssl;
 }
 
+// Returns true if OpenSSL installed the transmit keys into the socket during the handshake, in
+// which case application data can be written to the socket directly.
+static bool
+ktls_handshake_done(SSL *ssl)
+{
+  bool send = false;
+
+#ifdef SSL_OP_ENABLE_KTLS
+  if (BIO_get_ktls_recv(SSL_get_rbio(ssl))) {
+    SSL_INCREMENT_DYN_STAT(ssl_ktls_rx_connections_stat);
+  }
+  if (BIO_get_ktls_send(SSL_get_wbio(ssl))) {
+    SSL_INCREMENT_DYN_STAT(ssl_ktls_tx_connections_stat);
+    send = true;
+  }
+  Debug("ssl", "kTLS send=%d recv=%d", send, BIO_get_ktls_recv(SSL_get_rbio(ssl)) ? 1 : 0);
+#endif
+
+  return send;
+}
+
 static void
 debug_certificate_name(const char *msg, X509_NAME *name)
 {
@@ -472,6 +505,12 @@ SSLNetVConnection::update_rbio(bool move_to_socket)
   return retval;
 }
 
+bool
+SSLNetVConnection::is_spliceable() const
+{
+  return HttpProxyPort::TRANSPORT_BLIND_TUNNEL == this->attributes && super::is_spliceable();
+}
+
 // changed by YTS Team, yamsat
 void
 SSLNetVConnection::net_read_io(NetHandler *nh, EThread *lthread)
@@ -720,7 +759,8 @@ SSLNetVConnection::load_buffer_and_write(int64_t towrite, MIOBufferAccessor &buf
     Debug("ssl", "now=%" PRId64 " lastwrite=%" PRId64 " msec_since_last_write=%d", now, sslLastWriteTime, msec_since_last_write);
   }
 
-  if (HttpProxyPort::TRANSPORT_BLIND_TUNNEL == this->attributes) {
+  // With kernel TLS the socket encrypts plain writes itself, so skip SSL_write and its copy.
+  if (HttpProxyPort::TRANSPORT_BLIND_TUNNEL == this->attributes || this->sslKTLSSend) {
     return this->super::load_buffer_and_write(towrite, buf, total_written, needs);
   }
 
@@ -896,6 +936,11 @@ SSLNetVConnection::clear()
   sslTotalBytesSent           = 0;
   sslClientRenegotiationAbort = false;
   sslSessionCacheHit          = false;
+  sslKTLSSend                 = false;
+  if (sslAsyncBatched) {
+    sslAsyncBatched = false;
+    SSLAsyncBatchDone();
+  }
 
   curHook         = nullptr;
   hookOpRequested = SSL_HOOK_OP_DEFAULT;
@@ -1177,6 +1222,12 @@ SSLNetVConnection::sslServerHandShakeEvent(int &err)
   if (SSLConfigParams::async_handshake_enabled) {
     SSL_set_mode(ssl, SSL_MODE_ASYNC);
   }
+#endif
+#if TS_USE_TLS_ASYNC
+  if (sslAsyncBatched) {
+    sslAsyncBatched = false;
+    SSLAsyncBatchDone();
+  }
 #endif
   ssl_error_t ssl_error = SSLAccept(ssl);
 #if TS_USE_TLS_ASYNC
@@ -1195,6 +1246,7 @@ SSLNetVConnection::sslServerHandShakeEvent(int &err)
       this->ep.start(pd, waitfd, this, EVENTIO_READ);
       this->ep.type = EVENTIO_READWRITE_VC;
     }
+    sslAsyncBatched = SSLAsyncBatchAdd();
   } else if (SSLConfigParams::async_handshake_enabled) {
     // Clean up the epoll entry for signalling
     SSL_clear_mode(ssl, SSL_MODE_ASYNC);
@@ -1239,6 +1291,7 @@ SSLNetVConnection::sslServerHandShakeEvent(int &err)
     }
 
     sslHandshakeStatus = SSL_HANDSHAKE_DONE;
+    sslKTLSSend        = ktls_handshake_done(ssl);
 
     if (sslHandshakeBeginTime) {
       sslHandshakeEndTime                 = Thread::get_hrtime();
@@ -1394,6 +1447,7 @@ SSLNetVConnection::sslClientHandShakeEvent(int &err)
     SSL_INCREMENT_DYN_STAT(ssl_total_success_handshake_count_out_stat);
 
     sslHandshakeStatus = SSL_HANDSHAKE_DONE;
+    sslKTLSSend        = ktls_handshake_done(ssl);
     return EVENT_DONE;
 
   case SSL_ERROR_WANT_WRITE:
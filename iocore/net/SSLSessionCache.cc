@@ -23,7 +23,12 @@
 #include "SSLSessionCache.h"
 #include "SSLStats.h"
 
+#include <algorithm>
 #include <cstring>
+#include <fcntl.h>
+#include <sys/file.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
 
 #define SSLSESSIONCACHE_STRINGIFY0(x) #x
 #define SSLSESSIONCACHE_STRINGIFY(x) SSLSESSIONCACHE_STRINGIFY0(x)
@@ -35,59 +40,220 @@
 #define PRINT_BUCKET(x)
 #endif
 
+namespace
+{
+/// Identifies a cache region that may be reused, bump @c version when the layout changes.
+struct SSLSessionCacheHeader {
+  char magic[8];
+  uint32_t version;
+  uint32_t nbuckets;
+  uint32_t nslots;
+  uint32_t slot_size;
+};
+
+constexpr char SESSION_CACHE_MAGIC[8] = {'A', 'T', 'S', 'S', 'E', 'S', 'S', '\0'};
+constexpr uint32_t SESSION_CACHE_VERSION = 1;
+constexpr size_t SESSION_CACHE_ALIGN     = 64;
+constexpr int READ_ATTEMPTS              = 4;
+
+inline size_t
+align_up(size_t n)
+{
+  return (n + SESSION_CACHE_ALIGN - 1) & ~(SESSION_CACHE_ALIGN - 1);
+}
+
+// The index uses 0 for an empty entry, so force the stored hash to be non-zero.
+inline uint64_t
+index_hash(const SSLSessionID &sid)
+{
+  return sid.hash() | 1;
+}
+
+inline bool
+same_id(const SSLSessionSlot &slot, const SSLSessionID &sid)
+{
+  return slot.id_len == sid.len && memcmp(slot.id, sid.bytes, sid.len) == 0;
+}
+} // namespace
+
 /* Session Cache */
-SSLSessionCache::SSLSessionCache() : nbuckets(SSLConfigParams::session_cache_number_buckets)
+SSLSessionCache::SSLSessionCache()
+  : nbuckets(SSLConfigParams::session_cache_number_buckets), nslots(SSLConfigParams::session_cache_max_bucket_size)
 {
-  Debug("ssl.session_cache", "Created new ssl session cache %p with %zu buckets each with size max size %zu", this, nbuckets,
-        SSLConfigParams::session_cache_max_bucket_size);
+  ink_release_assert(nbuckets > 0 && nslots > 0);
+
+  bucket_stride = SSLSessionBucket::footprint(nslots);
+  region_size   = align_up(sizeof(SSLSessionCacheHeader)) + nbuckets * bucket_stride;
 
-  session_bucket = new SSLSessionBucket[nbuckets];
+  const char *path = SSLConfigParams::session_cache_shm_path;
+  if (path == nullptr || *path == '\0' || !map_shared(path, region_size)) {
+    map_anonymous(region_size);
+  }
+
+  Debug("ssl.session_cache", "Created new ssl session cache %p with %zu buckets each with size max size %zu (%zu bytes)", this,
+        nbuckets, nslots, region_size);
 }
 
 SSLSessionCache::~SSLSessionCache()
 {
-  delete[] session_bucket;
+  if (region) {
+    munmap(region, region_size);
+  }
+  if (shm_fd >= 0) {
+    close(shm_fd);
+  }
+}
+
+void
+SSLSessionCache::map_anonymous(size_t size)
+{
+  region = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+  if (region == MAP_FAILED) {
+    Fatal("unable to allocate %zu bytes for the SSL session cache: %s", size, strerror(errno));
+  }
+
+  // Anonymous memory is zero filled, only the buckets need setting up.
+  for (size_t i = 0; i < nbuckets; ++i) {
+    bucket(i)->init(nslots);
+  }
+}
+
+bool
+SSLSessionCache::map_shared(const char *path, size_t size)
+{
+  ats_scoped_fd fd(open(path, O_RDWR | O_CREAT | O_CLOEXEC, 0600));
+  struct stat st;
+
+  if (fd < 0 || fstat(fd, &st) < 0) {
+    Warning("unable to open SSL session cache file '%s', sessions will not persist: %s", path, strerror(errno));
+    return false;
+  }
+
+  // The file is sized and initialized below, which is only safe if no other process has it mapped.
+  // The lock is held for as long as the mapping lives.
+  if (flock(fd, LOCK_EX | LOCK_NB) < 0) {
+    Warning("SSL session cache file '%s' is in use by another process, sessions will not persist: %s", path, strerror(errno));
+    return false;
+  }
+
+  bool reuse = static_cast<size_t>(st.st_size) == size;
+  if (!reuse && ftruncate(fd, size) < 0) {
+    Warning("unable to size SSL session cache file '%s' to %zu bytes: %s", path, size, strerror(errno));
+    return false;
+  }
+
+  region = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+  if (region == MAP_FAILED) {
+    Warning("unable to map SSL session cache file '%s': %s", path, strerror(errno));
+    region = nullptr;
+    return false;
+  }
+
+  auto *header = static_cast<SSLSessionCacheHeader *>(region);
+  reuse        = reuse && memcmp(header->magic, SESSION_CACHE_MAGIC, sizeof(header->magic)) == 0 &&
+          header->version == SESSION_CACHE_VERSION && header->nbuckets == nbuckets && header->nslots == nslots &&
+          header->slot_size == sizeof(SSLSessionSlot);
+
+  size_t recovered = 0;
+  if (reuse) {
+    // A bucket left locked or inconsistent by a process that died in the middle of a write is
+    // emptied, the rest are used as they are.
+    for (size_t i = 0; i < nbuckets; ++i) {
+      if (bucket(i)->recover(nslots)) {
+        ++recovered;
+      } else {
+        bucket(i)->init(nslots);
+      }
+    }
+  } else {
+    memset(region, 0, size);
+    for (size_t i = 0; i < nbuckets; ++i) {
+      bucket(i)->init(nslots);
+    }
+    memcpy(header->magic, SESSION_CACHE_MAGIC, sizeof(header->magic));
+    header->version   = SESSION_CACHE_VERSION;
+    header->nbuckets  = nbuckets;
+    header->nslots    = nslots;
+    header->slot_size = sizeof(SSLSessionSlot);
+  }
+
+  shm_fd = fd.release();
+  Note("SSL session cache mapped from '%s', %zu of %zu buckets recovered", path, recovered, nbuckets);
+  return true;
+}
+
+SSLSessionBucket *
+SSLSessionCache::bucket(uint64_t hash) const
+{
+  char *base = static_cast<char *>(region) + align_up(sizeof(SSLSessionCacheHeader));
+  return reinterpret_cast<SSLSessionBucket *>(base + (hash % nbuckets) * bucket_stride);
 }
 
 int
 SSLSessionCache::getSessionBuffer(const SSLSessionID &sid, char *buffer, int &len) const
 {
-  uint64_t hash            = sid.hash();
-  uint64_t target_bucket   = hash % nbuckets;
-  SSLSessionBucket *bucket = &session_bucket[target_bucket];
+  SSLSessionBucket *bucket = this->bucket(sid.hash());
+  unsigned char data[SSL_MAX_SESSION_SIZE];
+  int true_len = bucket->getSessionBuffer(sid, data, sizeof(data), !SSLConfigParams::session_cache_skip_on_lock_contention);
 
-  return bucket->getSessionBuffer(sid, buffer, len);
+  if (true_len < 0) {
+    if (ssl_rsb) {
+      SSL_INCREMENT_DYN_STAT(ssl_session_cache_lock_contention);
+    }
+    return 0;
+  }
+  if (true_len > 0 && buffer) {
+    if (true_len < len) {
+      len = true_len;
+    }
+    memcpy(buffer, data, len);
+  }
+  return true_len;
 }
 
 bool
 SSLSessionCache::getSession(const SSLSessionID &sid, SSL_SESSION **sess) const
 {
   uint64_t hash            = sid.hash();
-  uint64_t target_bucket   = hash % nbuckets;
-  SSLSessionBucket *bucket = &session_bucket[target_bucket];
+  SSLSessionBucket *bucket = this->bucket(hash);
 
   if (is_debug_tag_set("ssl.session_cache")) {
     char buf[sid.len * 2 + 1];
     sid.toString(buf, sizeof(buf));
     Debug("ssl.session_cache.get", "SessionCache looking in bucket %" PRId64 " (%p) for session '%s' (hash: %" PRIX64 ").",
-          target_bucket, bucket, buf, hash);
+          hash % nbuckets, bucket, buf, hash);
+  }
+
+  unsigned char data[SSL_MAX_SESSION_SIZE];
+  int len = bucket->getSessionBuffer(sid, data, sizeof(data), !SSLConfigParams::session_cache_skip_on_lock_contention);
+
+  if (len < 0) {
+    if (ssl_rsb) {
+      SSL_INCREMENT_DYN_STAT(ssl_session_cache_lock_contention);
+    }
+    return false;
+  }
+  if (len == 0) {
+    Debug("ssl.session_cache", "Session with hash %" PRIX64 " not found in bucket %p.", hash, bucket);
+    return false;
   }
 
-  return bucket->getSession(sid, sess);
+  const unsigned char *loc = data;
+  *sess                    = d2i_SSL_SESSION(nullptr, &loc, len);
+  return *sess != nullptr;
 }
 
 void
 SSLSessionCache::removeSession(const SSLSessionID &sid)
 {
   uint64_t hash            = sid.hash();
-  uint64_t target_bucket   = hash % nbuckets;
-  SSLSessionBucket *bucket = &session_bucket[target_bucket];
+  SSLSessionBucket *bucket = this->bucket(hash);
 
   if (is_debug_tag_set("ssl.session_cache")) {
     char buf[sid.len * 2 + 1];
     sid.toString(buf, sizeof(buf));
     Debug("ssl.session_cache.remove", "SessionCache using bucket %" PRId64 " (%p): Removing session '%s' (hash: %" PRIX64 ").",
-          target_bucket, bucket, buf, hash);
+          hash % nbuckets, bucket, buf, hash);
   }
 
   if (ssl_rsb) {
@@ -100,22 +266,8 @@ void
 SSLSessionCache::insertSession(const SSLSessionID &sid, SSL_SESSION *sess)
 {
   uint64_t hash            = sid.hash();
-  uint64_t target_bucket   = hash % nbuckets;
-  SSLSessionBucket *bucket = &session_bucket[target_bucket];
-
-  if (is_debug_tag_set("ssl.session_cache")) {
-    char buf[sid.len * 2 + 1];
-    sid.toString(buf, sizeof(buf));
-    Debug("ssl.session_cache.insert", "SessionCache using bucket %" PRId64 " (%p): Inserting session '%s' (hash: %" PRIX64 ").",
-          target_bucket, bucket, buf, hash);
-  }
-
-  bucket->insertSession(sid, sess);
-}
+  SSLSessionBucket *bucket = this->bucket(hash);
 
-void
-SSLSessionBucket::insertSession(const SSLSessionID &id, SSL_SESSION *sess)
-{
   size_t len = i2d_SSL_SESSION(sess, nullptr); // make sure we're not going to need more than SSL_MAX_SESSION_SIZE bytes
   /* do not cache a session that's too big. */
   if (len > (size_t)SSL_MAX_SESSION_SIZE) {
@@ -124,181 +276,307 @@ SSLSessionBucket::insertSession(const SSLSessionID &id, SSL_SESSION *sess)
   }
 
   if (is_debug_tag_set("ssl.session_cache")) {
-    char buf[id.len * 2 + 1];
-    id.toString(buf, sizeof(buf));
-    Debug("ssl.session_cache", "Inserting session '%s' to bucket %p.", buf, this);
+    char buf[sid.len * 2 + 1];
+    sid.toString(buf, sizeof(buf));
+    Debug("ssl.session_cache.insert", "SessionCache using bucket %" PRId64 " (%p): Inserting session '%s' (hash: %" PRIX64 ").",
+          hash % nbuckets, bucket, buf, hash);
   }
 
-  MUTEX_TRY_LOCK(lock, mutex, this_ethread());
-  if (!lock.is_locked()) {
+  // Encode before taking the bucket so the writer section is only a copy.
+  unsigned char data[SSL_MAX_SESSION_SIZE];
+  unsigned char *loc = data;
+  i2d_SSL_SESSION(sess, &loc);
+
+  if (!bucket->insertSession(sid, data, len, false)) {
     if (ssl_rsb) {
       SSL_INCREMENT_DYN_STAT(ssl_session_cache_lock_contention);
     }
-    if (SSLConfigParams::session_cache_skip_on_lock_contention) {
-      return;
+    if (!SSLConfigParams::session_cache_skip_on_lock_contention) {
+      bucket->insertSession(sid, data, len, true);
     }
-    lock.acquire(this_ethread());
   }
+}
 
-  PRINT_BUCKET("insertSession before")
-  if (queue.size >= static_cast<int>(SSLConfigParams::session_cache_max_bucket_size)) {
-    removeOldestSession();
+/* Session Bucket */
+size_t
+SSLSessionBucket::index_size(size_t nslots)
+{
+  // Keep the index at most half full so probe sequences stay short.
+  size_t size = 1;
+  while (size < 2 * nslots) {
+    size <<= 1;
   }
+  return size;
+}
 
-  // Don't insert if it is already there
-  SSLSession *node = queue.tail;
-  while (node) {
-    if (node->session_id == id) {
-      return;
-    }
-    node = node->link.prev;
-  }
+size_t
+SSLSessionBucket::footprint(size_t nslots)
+{
+  return align_up(sizeof(SSLSessionBucket)) + align_up(index_size(nslots) * sizeof(IndexEntry)) +
+         align_up(nslots * sizeof(SSLSessionSlot));
+}
 
-  Ptr<IOBufferData> buf;
-  buf = new_IOBufferData(buffer_size_to_index(len, MAX_BUFFER_SIZE_INDEX), MEMALIGNED);
-  ink_release_assert(static_cast<size_t>(buf->block_size()) >= len);
-  unsigned char *loc = reinterpret_cast<unsigned char *>(buf->data());
-  i2d_SSL_SESSION(sess, &loc);
+SSLSessionBucket::IndexEntry *
+SSLSessionBucket::index() const
+{
+  return reinterpret_cast<IndexEntry *>(const_cast<char *>(reinterpret_cast<const char *>(this)) + align_up(sizeof(*this)));
+}
+
+SSLSessionSlot *
+SSLSessionBucket::slots() const
+{
+  return reinterpret_cast<SSLSessionSlot *>(reinterpret_cast<char *>(index()) + align_up((index_mask + 1) * sizeof(IndexEntry)));
+}
 
-  ats_scoped_obj<SSLSession> ssl_session(new SSLSession(id, buf, len));
+void
+SSLSessionBucket::init(size_t n)
+{
+  seq.store(0, std::memory_order_relaxed);
+  nslots     = n;
+  index_mask = index_size(n) - 1;
+  clock_hand = 0;
+  count      = 0;
+  memset(static_cast<void *>(index()), 0, (index_mask + 1) * sizeof(IndexEntry));
+  memset(static_cast<void *>(slots()), 0, nslots * sizeof(SSLSessionSlot));
+}
 
-  /* do the actual insert */
-  queue.enqueue(ssl_session.release());
+bool
+SSLSessionBucket::recover(size_t n)
+{
+  uint32_t s = seq.load(std::memory_order_relaxed);
 
-  PRINT_BUCKET("insertSession after")
+  if ((s & 1) || nslots != n || index_mask != index_size(n) - 1 || clock_hand >= nslots) {
+    return false;
+  }
+
+  uint32_t live = 0;
+  for (uint32_t i = 0; i <= index_mask; ++i) {
+    const IndexEntry &e = index()[i];
+    if (e.hash == 0) {
+      continue;
+    }
+    if (e.slot >= nslots) {
+      return false;
+    }
+    const SSLSessionSlot &slot = slots()[e.slot];
+    if (slot.id_len == 0 || slot.id_len > sizeof(slot.id) || slot.data_len > sizeof(slot.data) || (slot.hash | 1) != e.hash) {
+      return false;
+    }
+    ++live;
+  }
+
+  return live == count;
+}
+
+uint32_t
+SSLSessionBucket::home(uint64_t hash) const
+{
+  // The low bits picked the bucket, so mix before picking the index position.
+  return static_cast<uint32_t>((hash * 0x9E3779B97F4A7C15ULL) >> 32) & index_mask;
 }
 
 int
-SSLSessionBucket::getSessionBuffer(const SSLSessionID &id, char *buffer, int &len)
+SSLSessionBucket::find(const SSLSessionID &id, uint64_t hash) const
 {
-  int true_len = 0;
-  MUTEX_TRY_LOCK(lock, mutex, this_ethread());
-  if (!lock.is_locked()) {
-    if (ssl_rsb) {
-      SSL_INCREMENT_DYN_STAT(ssl_session_cache_lock_contention);
+  for (uint32_t pos = home(hash);; pos = (pos + 1) & index_mask) {
+    const IndexEntry &e = index()[pos];
+    if (e.hash == 0) {
+      return -1;
     }
-    if (SSLConfigParams::session_cache_skip_on_lock_contention) {
-      return true_len;
+    if (e.hash == hash && e.slot < nslots && same_id(slots()[e.slot], id)) {
+      return pos;
     }
+  }
+}
 
-    lock.acquire(this_ethread());
-  }
-
-  // We work backwards because that's the most likely place we'll find our session...
-  SSLSession *node = queue.tail;
-  while (node) {
-    if (node->session_id == id) {
-      true_len = node->len_asn1_data;
-      if (buffer) {
-        const unsigned char *loc = reinterpret_cast<const unsigned char *>(node->asn1_data->data());
-        if (true_len < len) {
-          len = true_len;
-        }
-        memcpy(buffer, loc, len);
-        return true_len;
-      }
+void
+SSLSessionBucket::erase(uint32_t pos)
+{
+  // Backward shift deletion: pull later entries of the probe sequence into the hole so lookups
+  // never need tombstones.
+  IndexEntry *idx = index();
+  uint32_t hole   = pos;
+
+  for (uint32_t j = (pos + 1) & index_mask; idx[j].hash != 0; j = (j + 1) & index_mask) {
+    if (((j - home(idx[j].hash)) & index_mask) >= ((j - hole) & index_mask)) {
+      idx[hole] = idx[j];
+      hole      = j;
     }
-    node = node->link.prev;
   }
-  return 0;
+  idx[hole].hash = 0;
+  idx[hole].slot = 0;
 }
 
-bool
-SSLSessionBucket::getSession(const SSLSessionID &id, SSL_SESSION **sess)
+uint32_t
+SSLSessionBucket::allocate()
 {
-  char buf[id.len * 2 + 1];
-  buf[0] = '\0'; // just to be safe.
-  if (is_debug_tag_set("ssl.session_cache")) {
-    id.toString(buf, sizeof(buf));
-  }
+  // CLOCK: take the first free slot, or evict the first session not read since the hand last passed.
+  SSLSessionSlot *s = slots();
 
-  Debug("ssl.session_cache", "Looking for session with id '%s' in bucket %p", buf, this);
+  for (;;) {
+    uint32_t victim = clock_hand;
+    clock_hand      = (clock_hand + 1) % nslots;
 
-  MUTEX_TRY_LOCK(lock, mutex, this_ethread());
-  if (!lock.is_locked()) {
-    if (ssl_rsb) {
-      SSL_INCREMENT_DYN_STAT(ssl_session_cache_lock_contention);
+    SSLSessionSlot &slot = s[victim];
+    if (slot.id_len == 0) {
+      return victim;
     }
-    if (SSLConfigParams::session_cache_skip_on_lock_contention) {
-      return false;
+    if (slot.referenced.load(std::memory_order_relaxed)) {
+      slot.referenced.store(0, std::memory_order_relaxed);
+      continue;
     }
 
-    lock.acquire(this_ethread());
-  }
+    if (is_debug_tag_set("ssl.session_cache")) {
+      SSLSessionID sid(reinterpret_cast<const unsigned char *>(slot.id), slot.id_len);
+      char buf[sid.len * 2 + 1];
+      sid.toString(buf, sizeof(buf));
+      Debug("ssl.session_cache", "Removing session '%s' from bucket %p because the bucket has size %u and max %u", buf, this, count,
+            nslots);
+    }
 
-  PRINT_BUCKET("getSession")
+    for (uint32_t pos = home(slot.hash | 1); index()[pos].hash != 0; pos = (pos + 1) & index_mask) {
+      if (index()[pos].slot == victim) {
+        erase(pos);
+        break;
+      }
+    }
+    slot.id_len = 0;
+    --count;
+    return victim;
+  }
+}
 
-  // We work backwards because that's the most likely place we'll find our session...
-  SSLSession *node = queue.tail;
-  while (node) {
-    if (node->session_id == id) {
-      const unsigned char *loc = reinterpret_cast<const unsigned char *>(node->asn1_data->data());
-      *sess                    = d2i_SSL_SESSION(nullptr, &loc, node->len_asn1_data);
+bool
+SSLSessionBucket::lock(bool wait)
+{
+  uint32_t s = seq.load(std::memory_order_relaxed);
 
+  for (;;) {
+    if ((s & 1) == 0 && seq.compare_exchange_weak(s, s + 1, std::memory_order_acquire, std::memory_order_relaxed)) {
       return true;
     }
-    node = node->link.prev;
+    if (!wait) {
+      return false;
+    }
+    sched_yield();
+    s = seq.load(std::memory_order_relaxed);
   }
+}
 
-  Debug("ssl.session_cache", "Session with id '%s' not found in bucket %p.", buf, this);
-  return false;
+void
+SSLSessionBucket::unlock()
+{
+  seq.fetch_add(1, std::memory_order_release);
 }
 
-void inline SSLSessionBucket::print(const char *ref_str) const
+bool
+SSLSessionBucket::insertSession(const SSLSessionID &id, const unsigned char *data, size_t len, bool wait)
 {
-  /* NOTE: This method assumes you're already holding the bucket lock */
-  if (!is_debug_tag_set("ssl.session_cache.bucket")) {
-    return;
+  if (!lock(wait)) {
+    return false;
   }
 
-  fprintf(stderr, "-------------- BUCKET %p (%s) ----------------\n", this, ref_str);
-  fprintf(stderr, "Current Size: %d, Max Size: %zd\n", queue.size, SSLConfigParams::session_cache_max_bucket_size);
-  fprintf(stderr, "Queue: \n");
+  PRINT_BUCKET("insertSession before")
 
-  SSLSession *node = queue.head;
-  while (node) {
-    char s_buf[2 * node->session_id.len + 1];
-    node->session_id.toString(s_buf, sizeof(s_buf));
-    fprintf(stderr, "  %s\n", s_buf);
-    node = node->link.next;
+  uint64_t hash = index_hash(id);
+
+  // Replace an existing entry for this id.
+  if (int pos = find(id, hash); pos >= 0) {
+    slots()[index()[pos].slot].id_len = 0;
+    erase(pos);
+    --count;
+  }
+
+  uint32_t victim      = allocate();
+  SSLSessionSlot &slot = slots()[victim];
+
+  slot.hash = id.hash();
+  slot.referenced.store(0, std::memory_order_relaxed);
+  slot.id_len   = id.len;
+  slot.data_len = len;
+  memcpy(slot.id, id.bytes, id.len);
+  memcpy(slot.data, data, len);
+
+  uint32_t pos = home(hash);
+  while (index()[pos].hash != 0) {
+    pos = (pos + 1) & index_mask;
   }
+  index()[pos].hash = hash;
+  index()[pos].slot = victim;
+  ++count;
+
+  PRINT_BUCKET("insertSession after")
+  unlock();
+  return true;
 }
 
-void inline SSLSessionBucket::removeOldestSession()
+int
+SSLSessionBucket::getSessionBuffer(const SSLSessionID &id, unsigned char *buffer, int len, bool wait) const
 {
-  // Caller must hold the bucket lock.
-  ink_assert(this_ethread() == mutex->thread_holding);
+  uint64_t hash = index_hash(id);
 
-  PRINT_BUCKET("removeOldestSession before")
-  while (queue.head && queue.size >= static_cast<int>(SSLConfigParams::session_cache_max_bucket_size)) {
-    SSLSession *old_head = queue.pop();
-    if (is_debug_tag_set("ssl.session_cache")) {
-      char buf[old_head->session_id.len * 2 + 1];
-      old_head->session_id.toString(buf, sizeof(buf));
-      Debug("ssl.session_cache", "Removing session '%s' from bucket %p because the bucket has size %d and max %zd", buf, this,
-            (queue.size + 1), SSLConfigParams::session_cache_max_bucket_size);
+  for (int attempt = 0; wait || attempt < READ_ATTEMPTS; ++attempt) {
+    uint32_t before = seq.load(std::memory_order_acquire);
+    if (before & 1) {
+      sched_yield();
+      continue;
+    }
+
+    int true_len        = 0;
+    SSLSessionSlot *hit = nullptr;
+    if (int pos = find(id, hash); pos >= 0) {
+      hit      = &slots()[index()[pos].slot];
+      true_len = std::min<int>(hit->data_len, SSL_MAX_SESSION_SIZE);
+      memcpy(buffer, hit->data, std::min(true_len, len));
+    }
+
+    // Anything read above may be torn if a writer got in, in which case try again.
+    std::atomic_thread_fence(std::memory_order_acquire);
+    if (seq.load(std::memory_order_relaxed) == before) {
+      if (hit && !hit->referenced.load(std::memory_order_relaxed)) {
+        hit->referenced.store(1, std::memory_order_relaxed);
+      }
+      return true_len;
     }
-    delete old_head;
   }
-  PRINT_BUCKET("removeOldestSession after")
+
+  return -1;
 }
 
-void
+bool
 SSLSessionBucket::removeSession(const SSLSessionID &id)
 {
-  SCOPED_MUTEX_LOCK(lock, mutex, this_ethread()); // We can't bail on contention here because this session MUST be removed.
-  SSLSession *node = queue.head;
-  while (node) {
-    if (node->session_id == id) {
-      queue.remove(node);
-      delete node;
-      return;
-    }
-    node = node->link.next;
+  lock(true); // We can't bail on contention here because this session MUST be removed.
+
+  int pos = find(id, index_hash(id));
+  if (pos >= 0) {
+    slots()[index()[pos].slot].id_len = 0;
+    erase(pos);
+    --count;
   }
+
+  unlock();
+  return pos >= 0;
 }
 
-/* Session Bucket */
-SSLSessionBucket::SSLSessionBucket() : mutex(new_ProxyMutex()) {}
+void inline SSLSessionBucket::print(const char *ref_str) const
+{
+  /* NOTE: This method assumes you're already holding the bucket lock */
+  if (!is_debug_tag_set("ssl.session_cache.bucket")) {
+    return;
+  }
 
-SSLSessionBucket::~SSLSessionBucket() {}
+  fprintf(stderr, "-------------- BUCKET %p (%s) ----------------\n", this, ref_str);
+  fprintf(stderr, "Current Size: %u, Max Size: %u\n", count, nslots);
+  fprintf(stderr, "Slots: \n");
+
+  for (uint32_t i = 0; i < nslots; ++i) {
+    const SSLSessionSlot &slot = slots()[i];
+    if (slot.id_len) {
+      SSLSessionID sid(reinterpret_cast<const unsigned char *>(slot.id), slot.id_len);
+      char s_buf[2 * sid.len + 1];
+      sid.toString(s_buf, sizeof(s_buf));
+      fprintf(stderr, "  %u: %s%s\n", i, s_buf, slot.referenced.load(std::memory_order_relaxed) ? " (referenced)" : "");
+    }
+  }
+}
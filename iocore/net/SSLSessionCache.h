@@ -21,7 +21,6 @@
 
 #pragma once
 
-#include "tscore/List.h"
 #include "tscore/ink_mutex.h"
 #include "P_EventSystem.h"
 #include "records/I_RecProcess.h"
@@ -29,6 +28,7 @@
 #include "P_SSLUtils.h"
 #include "ts/apidefs.h"
 #include <openssl/ssl.h>
+#include <atomic>
 
 #define SSL_MAX_SESSION_SIZE 256
 
@@ -109,38 +109,69 @@ struct SSLSessionID : public TSSslSessionID {
   }
 };
 
-class SSLSession
-{
-public:
-  SSLSessionID session_id;
-  Ptr<IOBufferData> asn1_data; /* this is the ASN1 representation of the SSL_CTX */
-  size_t len_asn1_data;
-
-  SSLSession(const SSLSessionID &id, const Ptr<IOBufferData> &ssl_asn1_data, size_t len_asn1)
-    : session_id(id), asn1_data(ssl_asn1_data), len_asn1_data(len_asn1)
-  {
-  }
+/** One cached session, stored inline.
 
-  LINK(SSLSession, link);
+    Slots never hold pointers so that the whole cache is a single flat region, which can be backed
+    by a shared file mapping and picked up again by the next traffic_server process.
+ */
+struct SSLSessionSlot {
+  uint64_t hash;                    ///< @c SSLSessionID::hash() of the session.
+  std::atomic<uint32_t> referenced; ///< CLOCK reference bit, set by readers without locking.
+  uint16_t id_len;                  ///< Length of the session id, 0 if the slot is free.
+  uint16_t data_len;                ///< Length of the ASN1 encoded session.
+  char id[TS_SSL_MAX_SSL_SESSION_ID_LENGTH];
+  unsigned char data[SSL_MAX_SESSION_SIZE];
 };
 
+/** A fixed capacity set of sessions.
+
+    Writers serialize on a sequence counter which is odd while the bucket is being modified. Readers
+    never lock, they copy the session out and retry if the counter changed meanwhile. Sessions are
+    located through an open addressing index of (hash, slot) pairs and evicted with the CLOCK
+    algorithm, so no operation walks the stored sessions.
+
+    A bucket is placed in memory provided by @c SSLSessionCache and is immediately followed by its
+    index and slots, @see footprint().
+ */
 class SSLSessionBucket
 {
 public:
-  SSLSessionBucket();
-  ~SSLSessionBucket();
-  void insertSession(const SSLSessionID &, SSL_SESSION *ctx);
-  bool getSession(const SSLSessionID &, SSL_SESSION **ctx);
-  int getSessionBuffer(const SSLSessionID &, char *buffer, int &len);
-  void removeSession(const SSLSessionID &);
+  /// Bytes needed for a bucket with @a nslots sessions, including the index and the slots.
+  static size_t footprint(size_t nslots);
+
+  void init(size_t nslots);
+  bool recover(size_t nslots);
+
+  bool insertSession(const SSLSessionID &, const unsigned char *data, size_t len, bool wait);
+  int getSessionBuffer(const SSLSessionID &, unsigned char *buffer, int len, bool wait) const;
+  bool removeSession(const SSLSessionID &);
 
 private:
+  struct IndexEntry {
+    uint64_t hash; ///< 0 marks an empty entry.
+    uint32_t slot;
+  };
+
+  static size_t index_size(size_t nslots);
+
+  IndexEntry *index() const;
+  SSLSessionSlot *slots() const;
+  uint32_t home(uint64_t hash) const;
+  int find(const SSLSessionID &id, uint64_t hash) const;
+  void erase(uint32_t pos);
+  uint32_t allocate();
+
+  bool lock(bool wait);
+  void unlock();
+
   /* these method must be used while hold the lock */
   void print(const char *) const;
-  void removeOldestSession();
 
-  Ptr<ProxyMutex> mutex;
-  CountQueue<SSLSession> queue;
+  std::atomic<uint32_t> seq;
+  uint32_t nslots;
+  uint32_t index_mask;
+  uint32_t clock_hand;
+  uint32_t count;
 };
 
 class SSLSessionCache
@@ -157,6 +188,14 @@ public:
   SSLSessionCache &operator=(const SSLSessionCache &) = delete;
 
 private:
-  SSLSessionBucket *session_bucket = nullptr;
+  SSLSessionBucket *bucket(uint64_t hash) const;
+  bool map_shared(const char *path, size_t size);
+  void map_anonymous(size_t size);
+
+  void *region         = nullptr;
+  size_t region_size   = 0;
+  size_t bucket_stride = 0;
+  int shm_fd           = -1; ///< Locked file behind a shared mapping, -1 if anonymous.
   size_t nbuckets;
+  size_t nslots;
 };
@@ -177,6 +177,18 @@ SSLInitializeStatistics()
   RecRegisterRawStat(ssl_rsb, RECT_PROCESS, "proxy.process.ssl.redo_record_size_count", RECD_COUNTER, RECP_PERSISTENT,
                      (int)ssl_total_dyn_redo_tls_record_count, RecRawStatSyncCount);
 
+  /* Kernel TLS offload */
+  RecRegisterRawStat(ssl_rsb, RECT_PROCESS, "proxy.process.ssl.ktls_tx_connections", RECD_COUNTER, RECP_PERSISTENT,
+                     (int)ssl_ktls_tx_connections_stat, RecRawStatSyncCount);
+  RecRegisterRawStat(ssl_rsb, RECT_PROCESS, "proxy.process.ssl.ktls_rx_connections", RECD_COUNTER, RECP_PERSISTENT,
+                     (int)ssl_ktls_rx_connections_stat, RecRawStatSyncCount);
+
+  /* Async crypto batching */
+  RecRegisterRawStat(ssl_rsb, RECT_PROCESS, "proxy.process.ssl.async_batch_flushes", RECD_COUNTER, RECP_PERSISTENT,
+                     (int)ssl_async_batch_flush_stat, RecRawStatSyncCount);
+  RecRegisterRawStat(ssl_rsb, RECT_PROCESS, "proxy.process.ssl.async_batch_jobs", RECD_COUNTER, RECP_PERSISTENT,
+                     (int)ssl_async_batch_jobs_stat, RecRawStatSyncSum);
+
   /* error stats */
   RecRegisterRawStat(ssl_rsb, RECT_PROCESS, "proxy.process.ssl.ssl_error_syscall", RECD_COUNTER, RECP_PERSISTENT,
                      (int)ssl_error_syscall, RecRawStatSyncCount);
@@ -83,6 +83,10 @@ enum SSL_Stats {
   ssl_session_cache_eviction,
   ssl_session_cache_lock_contention,
   ssl_session_cache_new_session,
+  ssl_ktls_tx_connections_stat,
+  ssl_ktls_rx_connections_stat,
+  ssl_async_batch_flush_stat,
+  ssl_async_batch_jobs_stat,
 
   /* error stats */
   ssl_error_syscall,
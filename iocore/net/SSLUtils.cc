@@ -41,7 +41,9 @@
 #include "SSLDiags.h"
 #include "SSLStats.h"
 
+#include <atomic>
 #include <string>
+#include <thread>
 #include <unistd.h>
 #include <termios.h>
 #include <vector>
@@ -843,6 +845,49 @@ ssl_track_free(void *ptr, const char * /*filename*/, int /*lineno*/)
   ats_track_free(ptr, &ssl_memory_freed);
 }
 
+#if TS_USE_TLS_ASYNC
+static ENGINE *async_batch_engine = nullptr;
+
+// How often a net thread polls the batching engine while handshakes on it wait for the engine.
+static constexpr ink_hrtime ASYNC_BATCH_POLL_PERIOD = HRTIME_MSECONDS(1);
+
+static void
+async_batch_poll()
+{
+  int status = 0;
+
+  if (!ENGINE_ctrl_cmd(async_batch_engine, SSLConfigParams::async_batch_flush_cmd, 0, &status, nullptr, 0)) {
+    Debug("ssl.async", "engine command '%s' failed", SSLConfigParams::async_batch_flush_cmd);
+  }
+}
+
+/**
+   Batching state of a net thread. The engine only hands back the results of operations when it is
+   polled, and one poll right after a batch is submitted does not wait for them, so the thread keeps
+   polling from a periodic event until every paused handshake has resumed.
+ */
+struct SSLAsyncBatchPoller : public Continuation {
+  int pending     = 0;       ///< Handshakes paused since the last flush.
+  int outstanding = 0;       ///< Handshakes paused and not yet resumed.
+  Event *event    = nullptr; ///< Periodic poll, set while @a outstanding is not zero.
+
+  int
+  pollEvent(int /* event ATS_UNUSED */, Event *e)
+  {
+    async_batch_poll();
+    if (outstanding <= 0) {
+      e->cancel();
+      event = nullptr;
+    }
+    return EVENT_CONT;
+  }
+
+  SSLAsyncBatchPoller() : Continuation(new_ProxyMutex()) { SET_HANDLER(&SSLAsyncBatchPoller::pollEvent); }
+};
+
+static thread_local SSLAsyncBatchPoller *async_batch_poller = nullptr;
+#endif
+
 /*
  * Some items are only initialized if certain config values are set
  * Must have a second pass that initializes after loading the SSL config
@@ -861,6 +906,84 @@ SSLPostConfigInitialize()
       // ERR_print_errors_fp(stderr);
     }
   }
+
+#if TS_USE_TLS_ASYNC
+  const char *batch_engine = SSLConfigParams::async_batch_engine;
+  if (SSLConfigParams::async_handshake_enabled && batch_engine && *batch_engine && async_batch_engine == nullptr) {
+    ENGINE *e = ENGINE_by_id(batch_engine);
+
+    if (e == nullptr) {
+      Error("unable to find crypto engine '%s' for async batching", batch_engine);
+    } else if (!ENGINE_init(e)) {
+      Error("unable to initialize crypto engine '%s' for async batching", batch_engine);
+      ENGINE_free(e);
+    } else if (ENGINE_ctrl(e, ENGINE_CTRL_GET_CMD_FROM_NAME, 0, SSLConfigParams::async_batch_flush_cmd, nullptr) <= 0) {
+      Error("crypto engine '%s' does not support the '%s' command, async batching is disabled", batch_engine,
+            SSLConfigParams::async_batch_flush_cmd);
+      ENGINE_finish(e);
+      ENGINE_free(e);
+    } else {
+      // Keep the functional reference for the life of the process, it holds the engine on its own.
+      ENGINE_free(e);
+      async_batch_engine = e;
+      Note("batching async crypto operations for engine '%s' in groups of up to %d", batch_engine,
+           SSLConfigParams::async_batch_size);
+    }
+  }
+#endif
+}
+
+bool
+SSLAsyncBatchAdd()
+{
+#if TS_USE_TLS_ASYNC
+  if (async_batch_engine == nullptr) {
+    return false;
+  }
+  if (async_batch_poller == nullptr) {
+    async_batch_poller = new SSLAsyncBatchPoller();
+  }
+  ++async_batch_poller->outstanding;
+  // A full batch goes out right away, a partial one at the end of the net loop pass.
+  if (++async_batch_poller->pending >= SSLConfigParams::async_batch_size) {
+    SSLAsyncBatchFlush();
+  }
+  return true;
+#else
+  return false;
+#endif
+}
+
+void
+SSLAsyncBatchDone()
+{
+#if TS_USE_TLS_ASYNC
+  ink_assert(async_batch_poller && async_batch_poller->outstanding > 0);
+  --async_batch_poller->outstanding;
+#endif
+}
+
+void
+SSLAsyncBatchFlush()
+{
+#if TS_USE_TLS_ASYNC
+  SSLAsyncBatchPoller *poller = async_batch_poller;
+
+  if (poller == nullptr || poller->pending == 0) {
+    return;
+  }
+
+  int jobs        = poller->pending;
+  poller->pending = 0;
+
+  async_batch_poll();
+  SSL_INCREMENT_DYN_STAT(ssl_async_batch_flush_stat);
+  SSL_INCREMENT_DYN_STAT_EX(ssl_async_batch_jobs_stat, jobs);
+
+  if (poller->outstanding > 0 && poller->event == nullptr) {
+    poller->event = this_ethread()->schedule_every(poller, ASYNC_BATCH_POLL_PERIOD);
+  }
+#endif
 }
 
 void
@@ -1375,9 +1498,7 @@ SSLMultiCertConfigLoader::init_server_ssl_ctx(std::vector<X509 *> &cert_list, co
   SSL_CTX_set_next_protos_advertised_cb(ctx, SSLNetVConnection::advertise_next_protocol, nullptr);
   SSL_CTX_set_alpn_select_cb(ctx, SSLNetVConnection::select_next_protocol, nullptr);
 
-  if (SSLConfigParams::init_ssl_ctx_cb) {
-    SSLConfigParams::init_ssl_ctx_cb(ctx, true);
-  }
+  SSLMultiCertConfigLoader::run_init_ssl_ctx_cb(ctx);
 
   return ctx;
 
@@ -1432,7 +1553,7 @@ SSLMultiCertConfigLoader::_store_ssl_ctx(SSLCertLookup *lookup, const shared_SSL
   std::vector<X509 *> cert_list;
   shared_ssl_ticket_key_block keyblock = nullptr;
   bool inserted                        = false;
-  shared_SSL_CTX ctx(this->init_server_ssl_ctx(cert_list, sslMultCertSettings.get()), SSL_CTX_free);
+  shared_SSL_CTX ctx(this->_take_server_ssl_ctx(cert_list, sslMultCertSettings.get()), SSL_CTX_free);
 
   if (!ctx || !sslMultCertSettings) {
     lookup->is_valid = false;
@@ -1488,9 +1609,7 @@ SSLMultiCertConfigLoader::_store_ssl_ctx(SSLCertLookup *lookup, const shared_SSL
   }
 
   if (inserted) {
-    if (SSLConfigParams::init_ssl_ctx_cb) {
-      SSLConfigParams::init_ssl_ctx_cb(ctx.get(), true);
-    }
+    SSLMultiCertConfigLoader::run_init_ssl_ctx_cb(ctx.get());
   }
 
   if (!inserted) {
@@ -1504,6 +1623,87 @@ SSLMultiCertConfigLoader::_store_ssl_ctx(SSLCertLookup *lookup, const shared_SSL
   return ctx.get();
 }
 
+// Set on the threads started by _prepare_ssl_ctxs(), which leave the lifecycle hooks to the loading thread.
+static thread_local bool init_ssl_ctx_cb_deferred = false;
+
+void
+SSLMultiCertConfigLoader::run_init_ssl_ctx_cb(SSL_CTX *ctx)
+{
+  if (SSLConfigParams::init_ssl_ctx_cb && !init_ssl_ctx_cb_deferred) {
+    SSLConfigParams::init_ssl_ctx_cb(ctx, true);
+  }
+}
+
+SSL_CTX *
+SSLMultiCertConfigLoader::_take_server_ssl_ctx(std::vector<X509 *> &cert_list, const SSLMultiCertConfigParams *sslMultCertSettings)
+{
+  if (auto spot = this->_prepared.find(sslMultCertSettings); spot != this->_prepared.end()) {
+    SSL_CTX *ctx = spot->second.ctx;
+    cert_list    = std::move(spot->second.cert_list);
+    this->_prepared.erase(spot);
+    return ctx;
+  }
+  return this->init_server_ssl_ctx(cert_list, sslMultCertSettings);
+}
+
+/**
+   Build the server contexts for @a entries on @a nthreads threads. Loading certificates and keys
+   dominates the time to read a large ssl_multicert.config and each entry is independent, indexing
+   is still done afterwards in file order so the first entry for a name keeps winning.
+
+   The TS_LIFECYCLE_SERVER_SSL_CTX_INITIALIZED hooks are not run on the worker threads, plugins
+   expect them on the loading thread, so they are run here after the workers finish, in file order.
+   @a elevate is the ElevateAccess level the caller holds.
+ */
+void
+SSLMultiCertConfigLoader::_prepare_ssl_ctxs(const std::vector<shared_SSLMultiCertConfigParams> &entries, int nthreads,
+                                            unsigned elevate)
+{
+  std::vector<PreparedCtx> prepared(entries.size());
+  std::atomic<size_t> next{0};
+  std::vector<std::thread> threads;
+
+  auto worker = [&]() {
+#if TS_USE_POSIX_CAP
+    // Capabilities are per thread, the caller's elevation does not carry over to this one. Without
+    // them the effective uid is changed, which applies to the whole process.
+    ElevateAccess elevate_access(elevate);
+#endif
+    init_ssl_ctx_cb_deferred = true;
+    for (size_t i = next++; i < entries.size(); i = next++) {
+      const SSLMultiCertConfigParams *settings = entries[i].get();
+      // The builtin dialog prompts on the terminal, leave those entries to the serial pass.
+      if (settings->dialog && strcmp(settings->dialog, "builtin") == 0) {
+        continue;
+      }
+      prepared[i].ctx = this->init_server_ssl_ctx(prepared[i].cert_list, settings);
+      if (prepared[i].ctx == nullptr) {
+        // init_server_ssl_ctx() already released the certificates.
+        prepared[i].cert_list.clear();
+      }
+    }
+  };
+
+  nthreads = std::min<int>(nthreads, entries.size());
+  Debug("ssl", "building %zu server contexts on %d threads", entries.size(), nthreads);
+  for (int i = 0; i < nthreads; ++i) {
+    threads.emplace_back(worker);
+  }
+  for (auto &t : threads) {
+    t.join();
+  }
+
+  for (size_t i = 0; i < entries.size(); ++i) {
+    const SSLMultiCertConfigParams *settings = entries[i].get();
+    if (!(settings->dialog && strcmp(settings->dialog, "builtin") == 0)) {
+      if (prepared[i].ctx) {
+        SSLMultiCertConfigLoader::run_init_ssl_ctx_cb(prepared[i].ctx);
+      }
+      this->_prepared.emplace(settings, std::move(prepared[i]));
+    }
+  }
+}
+
 static bool
 ssl_extract_certificate(const matcher_line *line_info, SSLMultiCertConfigParams *sslMultCertSettings)
 {
@@ -1581,6 +1781,7 @@ SSLMultiCertConfigLoader::load(SSLCertLookup *lookup)
   ats_scoped_str file_buf;
   unsigned line_num = 0;
   matcher_line line_info;
+  std::vector<shared_SSLMultiCertConfigParams> entries;
 
   const matcher_tags sslCertTags = {nullptr, nullptr, nullptr, nullptr, nullptr, nullptr, false};
 
@@ -1599,7 +1800,11 @@ SSLMultiCertConfigLoader::load(SSLCertLookup *lookup)
   // certificates. The destructor will drop privilege for us.
   uint32_t elevate_setting = 0;
   REC_ReadConfigInteger(elevate_setting, "proxy.config.ssl.cert.load_elevated");
-  ElevateAccess elevate_access(elevate_setting ? ElevateAccess::FILE_PRIVILEGE : 0);
+  unsigned elevate_level = elevate_setting ? ElevateAccess::FILE_PRIVILEGE : 0;
+  ElevateAccess elevate_access(elevate_level);
+
+  int load_threads = 1;
+  REC_ReadConfigInt32(load_threads, "proxy.config.ssl.server.multicert.load_threads");
 
   line = tokLine(file_buf, &tok_state);
   while (line != nullptr) {
@@ -1623,7 +1828,7 @@ SSLMultiCertConfigLoader::load(SSLCertLookup *lookup)
         if (ssl_extract_certificate(&line_info, sslMultiCertSettings.get())) {
           // There must be a certificate specified unless the tunnel action is set
           if (sslMultiCertSettings->cert || sslMultiCertSettings->opt != SSLCertContextOption::OPT_TUNNEL) {
-            this->_store_ssl_ctx(lookup, sslMultiCertSettings);
+            entries.push_back(sslMultiCertSettings);
           } else {
             Warning("No ssl_cert_name specified and no tunnel action set");
           }
@@ -1634,6 +1839,14 @@ SSLMultiCertConfigLoader::load(SSLCertLookup *lookup)
     line = tokLine(nullptr, &tok_state);
   }
 
+  if (load_threads > 1 && entries.size() > 1) {
+    this->_prepare_ssl_ctxs(entries, load_threads, elevate_level);
+  }
+  for (auto &entry : entries) {
+    this->_store_ssl_ctx(lookup, entry);
+  }
+  ink_assert(this->_prepared.empty());
+
   // We *must* have a default context even if it can't possibly work. The default context is used to
   // bootstrap the SSL handshake so that we can subsequently do the SNI lookup to switch to the real
   // context.
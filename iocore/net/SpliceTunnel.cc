@@ -0,0 +1,422 @@
+/** @file
+
+  Kernel splice() tunnel between two net connections.
+
+  @section license License
+
+  Licensed to the Apache Software Foundation (ASF) under one
+  or more contributor license agreements.  See the NOTICE file
+  distributed with this work for additional information
+  regarding copyright ownership.  The ASF licenses this file
+  to you under the Apache License, Version 2.0 (the
+  "License"); you may not use this file except in compliance
+  with the License.  You may obtain a copy of the License at
+
+      http://www.apache.org/licenses/LICENSE-2.0
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+ */
+
+#include "P_Net.h"
+
+#include <fcntl.h>
+#include <unistd.h>
+
+#if HAVE_SPLICE
+
+namespace
+{
+void
+close_pipe(NetSplice &ch)
+{
+  for (int &fd : ch.pipe_fd) {
+    if (fd != -1) {
+      ::close(fd);
+      fd = -1;
+    }
+  }
+}
+
+bool
+open_pipe(NetSplice &ch)
+{
+  if (pipe2(ch.pipe_fd, O_NONBLOCK | O_CLOEXEC) < 0) {
+    return false;
+  }
+#ifdef F_SETPIPE_SZ
+  if (net_splice_pipe_size > 0) {
+    // Not fatal, the kernel caps unprivileged processes at /proc/sys/fs/pipe-max-size.
+    fcntl(ch.pipe_fd[1], F_SETPIPE_SZ, net_splice_pipe_size);
+  }
+  ch.pipe_size = fcntl(ch.pipe_fd[1], F_GETPIPE_SZ);
+#endif
+  if (ch.pipe_size <= 0) {
+    ch.pipe_size = 65536; // Linux default pipe capacity
+  }
+  return true;
+}
+
+// Like read_disable() / write_disable() but without touching the inactivity timeout, the other
+// direction of the tunnel may still be using the connection.
+void
+splice_read_disable(NetHandler *nh, UnixNetVConnection *vc)
+{
+  vc->read.enabled = 0;
+  nh->read_ready_list.remove(vc);
+  vc->ep.modify(-EVENTIO_READ);
+}
+
+void
+splice_write_disable(NetHandler *nh, UnixNetVConnection *vc)
+{
+  vc->write.enabled = 0;
+  nh->write_ready_list.remove(vc);
+  vc->ep.modify(-EVENTIO_WRITE);
+}
+} // namespace
+
+void
+NetSplice::read_from_net(NetHandler *nh)
+{
+  ProxyMutex *mutex = src->thread->mutex.get();
+
+  if (in_pipe < pipe_size) {
+    ssize_t r = ::splice(src->con.fd, nullptr, pipe_fd[1], nullptr, pipe_size - in_pipe, SPLICE_F_MOVE | SPLICE_F_NONBLOCK);
+    NET_INCREMENT_DYN_STAT(net_calls_to_read_stat);
+
+    if (r > 0) {
+      in_pipe += r;
+      bytes_read += r;
+      src->read.vio.ndone += r;
+      NET_SUM_DYN_STAT(net_read_bytes_stat, r);
+      net_activity(src, src->thread);
+    } else if (r == 0) {
+      eos = true;
+    } else if (errno == EAGAIN || errno == ENOTCONN) {
+      NET_INCREMENT_DYN_STAT(net_calls_to_read_nodata_stat);
+      src->read.triggered = 0;
+      nh->read_ready_list.remove(src);
+    } else {
+      tunnel->fail(VC_EVENT_ERROR, errno);
+      return;
+    }
+  }
+
+  // Push what we have straight on, the destination is usually writable.
+  if (in_pipe > 0 && !drain(nh)) {
+    return;
+  }
+
+  if (eos) {
+    stop_reading(nh);
+    if (in_pipe == 0) {
+      tunnel->finish_channel(*this);
+    }
+  } else if (in_pipe >= pipe_size) {
+    // Pipe is full, wait for the destination to drain it.
+    splice_read_disable(nh, src);
+  } else {
+    src->readReschedule(nh);
+  }
+}
+
+void
+NetSplice::write_to_net(NetHandler *nh)
+{
+  if (!drain(nh)) {
+    return;
+  }
+  if (in_pipe == 0 && eos) {
+    tunnel->finish_channel(*this);
+  } else if (!eos && in_pipe < pipe_size && !src->read.enabled) {
+    src->read.vio.reenable();
+  }
+}
+
+bool
+NetSplice::drain(NetHandler *nh)
+{
+  ProxyMutex *mutex = dst->thread->mutex.get();
+
+  while (in_pipe > 0) {
+    ssize_t r = ::splice(pipe_fd[0], nullptr, dst->con.fd, nullptr, in_pipe, SPLICE_F_MOVE | SPLICE_F_NONBLOCK);
+    NET_INCREMENT_DYN_STAT(net_calls_to_write_stat);
+
+    if (r > 0) {
+      in_pipe -= r;
+      bytes_written += r;
+      dst->write.vio.ndone += r;
+      NET_SUM_DYN_STAT(net_write_bytes_stat, r);
+      NET_SUM_DYN_STAT(net_splice_bytes_stat, r);
+      net_activity(dst, dst->thread);
+    } else if (r < 0 && errno == EAGAIN) {
+      NET_INCREMENT_DYN_STAT(net_calls_to_write_nodata_stat);
+      dst->write.triggered = 0;
+      nh->write_ready_list.remove(dst);
+      break;
+    } else {
+      tunnel->fail(VC_EVENT_ERROR, r < 0 ? errno : EPIPE);
+      return false;
+    }
+  }
+
+  if (in_pipe > 0) {
+    if (dst->write.enabled) {
+      dst->writeReschedule(nh);
+    } else {
+      dst->write.vio.reenable();
+    }
+  } else if (dst->write.enabled) {
+    splice_write_disable(nh, dst);
+  }
+  return true;
+}
+
+void
+NetSplice::stop_reading(NetHandler *nh)
+{
+  src->read.triggered = 0;
+  splice_read_disable(nh, src);
+}
+
+#endif // HAVE_SPLICE
+
+SpliceTunnel::SpliceTunnel() : Continuation(nullptr)
+{
+  SET_HANDLER(&SpliceTunnel::main_event);
+}
+
+bool
+SpliceTunnel::can_splice(NetVConnection *a, NetVConnection *b)
+{
+#if HAVE_SPLICE
+  if (!net_splice_tunnel || a == nullptr || b == nullptr || a == b) {
+    return false;
+  }
+  auto *ua = dynamic_cast<UnixNetVConnection *>(a);
+  auto *ub = dynamic_cast<UnixNetVConnection *>(b);
+
+  return ua && ub && ua->is_spliceable() && ub->is_spliceable() && ua->thread == this_ethread() && ub->thread == this_ethread() &&
+         !ua->get_is_multiplexed() && !ub->get_is_multiplexed();
+#else
+  (void)a;
+  (void)b;
+  return false;
+#endif
+}
+
+SpliceTunnel *
+SpliceTunnel::start(Continuation *owner, NetVConnection *a, NetVConnection *b, IOBufferReader *a_to_b, IOBufferReader *b_to_a)
+{
+#if HAVE_SPLICE
+  ink_assert(can_splice(a, b));
+
+  SpliceTunnel *tunnel = new SpliceTunnel;
+  NetSplice &ab        = tunnel->_channel[A_TO_B];
+  NetSplice &ba        = tunnel->_channel[B_TO_A];
+
+  if (!open_pipe(ab) || !open_pipe(ba)) {
+    Debug("splice", "unable to create pipes: %s", strerror(errno));
+    close_pipe(ab);
+    close_pipe(ba);
+    delete tunnel;
+    return nullptr;
+  }
+
+  tunnel->mutex  = owner->mutex;
+  tunnel->_owner = owner;
+  ab.tunnel = ba.tunnel = tunnel;
+  ab.src = ba.dst = static_cast<UnixNetVConnection *>(a);
+  ab.dst = ba.src = static_cast<UnixNetVConnection *>(b);
+  ab.prefix       = a_to_b;
+  ba.prefix       = b_to_a;
+
+  ProxyMutex *mutex = this_ethread()->mutex.get();
+  NET_INCREMENT_DYN_STAT(net_splice_tunnels_stat);
+  Debug("splice", "tunnel %p between NetVC %p and %p, pipe sizes %" PRId64 " / %" PRId64, tunnel, a, b, ab.pipe_size, ba.pipe_size);
+
+  for (NetSplice *ch : {&ab, &ba}) {
+    if (ch->prefix && ch->prefix->read_avail() > 0) {
+      // Stop the owner's read on the source now, anything it read after the prefix was taken would be
+      // dropped by start_splice(). The source stays idle until the prefix is written.
+      ch->src->do_io_read(tunnel, 0, nullptr);
+      ch->dst->do_io_write(tunnel, ch->prefix->read_avail(), ch->prefix);
+    } else {
+      tunnel->start_splice(*ch);
+    }
+  }
+  return tunnel;
+#else
+  (void)owner;
+  (void)a;
+  (void)b;
+  (void)a_to_b;
+  (void)b_to_a;
+  return nullptr;
+#endif
+}
+
+void
+SpliceTunnel::start_splice(NetSplice &ch)
+{
+  ch.prefix = nullptr;
+
+  UnixNetVConnection *src = ch.src;
+  src->read.vio.op        = VIO::READ;
+  src->read.vio.mutex     = mutex;
+  src->read.vio.cont      = this;
+  src->read.vio.nbytes    = INT64_MAX;
+  src->read.vio.ndone     = 0;
+  src->read.vio.vc_server = src;
+  src->read.vio.buffer.clear();
+  src->read.splice = &ch;
+
+  UnixNetVConnection *dst  = ch.dst;
+  dst->write.vio.op        = VIO::WRITE;
+  dst->write.vio.mutex     = mutex;
+  dst->write.vio.cont      = this;
+  dst->write.vio.nbytes    = INT64_MAX;
+  dst->write.vio.ndone     = 0;
+  dst->write.vio.vc_server = dst;
+  dst->write.vio.buffer.clear();
+  dst->write.splice = &ch;
+
+  // Force a fresh enable so the socket goes back into the poll set even if the previous user of the
+  // VIO left it enabled; the pipe is empty so the write side stays off until there is something to send.
+  src->read.enabled  = 0;
+  dst->write.enabled = 0;
+  src->read.vio.reenable();
+}
+
+void
+SpliceTunnel::finish_channel(NetSplice &ch)
+{
+  ch.done = true;
+  Debug("splice", "tunnel %p NetVC %p -> %p done, %" PRId64 " bytes", this, ch.src, ch.dst, ch.bytes_written);
+
+  // Forward the half close, the other direction may still be running.
+  ch.src->read.splice  = nullptr;
+  ch.dst->write.splice = nullptr;
+  ch.src->do_io_shutdown(IO_SHUTDOWN_READ);
+  ch.dst->do_io_shutdown(IO_SHUTDOWN_WRITE);
+
+  if (_channel[A_TO_B].done && _channel[B_TO_A].done) {
+    signal_done();
+  }
+}
+
+void
+SpliceTunnel::fail(int event, int lerrno)
+{
+  Debug("splice", "tunnel %p stopped by %d, errno %d", this, event, lerrno);
+  error_event = event;
+
+  for (NetSplice &ch : _channel) {
+    if (ch.done) {
+      continue;
+    }
+    ch.done = true;
+    if (lerrno) {
+      ch.src->lerrno = lerrno;
+    }
+    if (ch.src->read.splice == &ch) {
+      ch.src->read.splice  = nullptr;
+      ch.src->read.enabled = 0;
+    }
+    if (ch.dst->write.splice == &ch) {
+      ch.dst->write.splice  = nullptr;
+      ch.dst->write.enabled = 0;
+    }
+  }
+  signal_done();
+}
+
+void
+SpliceTunnel::signal_done()
+{
+  // Call back from a fresh event rather than from inside the NetHandler, the owner closes both
+  // connections in response.
+  if (!_signalled) {
+    _signalled  = true;
+    _done_event = this_ethread()->schedule_imm(this, NET_EVENT_SPLICE_DONE);
+  }
+}
+
+int
+SpliceTunnel::main_event(int event, void *data)
+{
+  if (event == NET_EVENT_SPLICE_DONE) {
+    _done_event = nullptr;
+    _owner->handleEvent(NET_EVENT_SPLICE_DONE, this);
+    return EVENT_DONE;
+  }
+
+  if (_signalled) {
+    return EVENT_DONE;
+  }
+
+  VIO *vio = static_cast<VIO *>(data);
+  for (NetSplice &ch : _channel) {
+    if (ch.prefix && vio == &ch.dst->write.vio) {
+      switch (event) {
+      case VC_EVENT_WRITE_READY:
+        return EVENT_CONT;
+      case VC_EVENT_WRITE_COMPLETE:
+        ch.bytes_written += vio->ndone;
+        start_splice(ch);
+        return EVENT_CONT;
+      default:
+        break;
+      }
+    }
+  }
+
+  switch (event) {
+  case VC_EVENT_ERROR:
+  case VC_EVENT_EOS:
+  case VC_EVENT_INACTIVITY_TIMEOUT:
+  case VC_EVENT_ACTIVE_TIMEOUT:
+    fail(event);
+    break;
+  default:
+    Debug("splice", "tunnel %p ignoring event %d", this, event);
+    break;
+  }
+  return EVENT_CONT;
+}
+
+void
+SpliceTunnel::destroy()
+{
+  if (_done_event) {
+    _done_event->cancel();
+    _done_event = nullptr;
+  }
+  for (NetSplice &ch : _channel) {
+    if (ch.src) {
+      if (ch.src->read.splice == &ch) {
+        ch.src->read.splice = nullptr;
+      }
+      if (ch.src->read.vio.cont == this) {
+        ch.src->do_io_read(nullptr, 0, nullptr);
+      }
+    }
+    if (ch.dst) {
+      if (ch.dst->write.splice == &ch) {
+        ch.dst->write.splice = nullptr;
+      }
+      if (ch.dst->write.vio.cont == this) {
+        ch.dst->do_io_write(nullptr, 0, nullptr);
+      }
+    }
+#if HAVE_SPLICE
+    close_pipe(ch);
+#endif
+  }
+  mutex = nullptr;
+  delete this;
+}
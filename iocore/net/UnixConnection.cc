@@ -409,6 +409,13 @@ Connection::apply_options(NetVCOptions const &opt)
       safe_setsockopt(fd, SOL_SOCKET, SO_LINGER, (char *)&l, sizeof(l));
       Debug("socket", "::open:: setsockopt() turn on SO_LINGER on socket");
     }
+#ifdef TCP_NOTSENT_LOWAT
+    if (net_sock_notsent_lowat > 0) {
+      int lowat = net_sock_notsent_lowat;
+      safe_setsockopt(fd, IPPROTO_TCP, TCP_NOTSENT_LOWAT, reinterpret_cast<char *>(&lowat), sizeof(lowat));
+      Debug("socket", "::open: setsockopt() TCP_NOTSENT_LOWAT %d on socket", lowat);
+    }
+#endif
   }
 
 #if TS_HAS_SO_MARK
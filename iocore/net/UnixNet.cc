@@ -29,6 +29,7 @@ ink_hrtime last_throttle_warning;
 ink_hrtime last_shedding_warning;
 int net_connections_throttle;
 bool net_memory_throttle = false;
+int net_memory_usage_pct = 0;
 int fds_throttle;
 int fds_limit = 8000;
 ink_hrtime last_transient_accept_error;
@@ -97,6 +98,8 @@ public:
     // Cleanup the active and keep-alive queues periodically
     nh.manage_active_queue(true); // close any connections over the active timeout
     nh.manage_keep_alive_queue();
+    nh.update_pressure();
+    nh.shed_keep_alive_queue();
 
     return 0;
   }
@@ -275,6 +278,15 @@ NetHandler::update_nethandler_config(const char *str, RecDataT, RecData data, vo
   } else if (name == "proxy.config.net.default_inactivity_timeout"sv) {
     updated_member = &NetHandler::global_config.default_inactivity_timeout;
     Debug("net_queue", "proxy.config.net.default_inactivity_timeout updated to %" PRId64, data.rec_int);
+  } else if (name == "proxy.config.net.keep_alive_shed_threshold"sv) {
+    updated_member = &NetHandler::global_config.keep_alive_shed_threshold;
+    Debug("net_queue", "proxy.config.net.keep_alive_shed_threshold updated to %" PRId64, data.rec_int);
+  } else if (name == "proxy.config.net.keep_alive_shed_min_timeout"sv) {
+    updated_member = &NetHandler::global_config.keep_alive_shed_min_timeout;
+    Debug("net_queue", "proxy.config.net.keep_alive_shed_min_timeout updated to %" PRId64, data.rec_int);
+  } else if (name == "proxy.config.net.max_io_per_loop"sv) {
+    updated_member = &NetHandler::global_config.max_io_per_loop;
+    Debug("net_queue", "proxy.config.net.max_io_per_loop updated to %" PRId64, data.rec_int);
   }
 
   if (updated_member) {
@@ -310,6 +322,9 @@ NetHandler::init_for_process()
   REC_ReadConfigInt32(global_config.transaction_no_activity_timeout_in, "proxy.config.net.transaction_no_activity_timeout_in");
   REC_ReadConfigInt32(global_config.keep_alive_no_activity_timeout_in, "proxy.config.net.keep_alive_no_activity_timeout_in");
   REC_ReadConfigInt32(global_config.default_inactivity_timeout, "proxy.config.net.default_inactivity_timeout");
+  REC_ReadConfigInt32(global_config.keep_alive_shed_threshold, "proxy.config.net.keep_alive_shed_threshold");
+  REC_ReadConfigInt32(global_config.keep_alive_shed_min_timeout, "proxy.config.net.keep_alive_shed_min_timeout");
+  REC_ReadConfigInt32(global_config.max_io_per_loop, "proxy.config.net.max_io_per_loop");
 
   RecRegisterConfigUpdateCb("proxy.config.net.max_connections_in", update_nethandler_config, nullptr);
   RecRegisterConfigUpdateCb("proxy.config.net.max_active_connections_in", update_nethandler_config, nullptr);
@@ -317,6 +332,9 @@ NetHandler::init_for_process()
   RecRegisterConfigUpdateCb("proxy.config.net.transaction_no_activity_timeout_in", update_nethandler_config, nullptr);
   RecRegisterConfigUpdateCb("proxy.config.net.keep_alive_no_activity_timeout_in", update_nethandler_config, nullptr);
   RecRegisterConfigUpdateCb("proxy.config.net.default_inactivity_timeout", update_nethandler_config, nullptr);
+  RecRegisterConfigUpdateCb("proxy.config.net.keep_alive_shed_threshold", update_nethandler_config, nullptr);
+  RecRegisterConfigUpdateCb("proxy.config.net.keep_alive_shed_min_timeout", update_nethandler_config, nullptr);
+  RecRegisterConfigUpdateCb("proxy.config.net.max_io_per_loop", update_nethandler_config, nullptr);
 
   Debug("net_queue", "proxy.config.net.max_connections_in updated to %d", global_config.max_connections_in);
   Debug("net_queue", "proxy.config.net.max_active_connections_in updated to %d", global_config.max_connections_active_in);
@@ -326,6 +344,9 @@ NetHandler::init_for_process()
   Debug("net_queue", "proxy.config.net.keep_alive_no_activity_timeout_in updated to %d",
         global_config.keep_alive_no_activity_timeout_in);
   Debug("net_queue", "proxy.config.net.default_inactivity_timeout updated to %d", global_config.default_inactivity_timeout);
+  Debug("net_queue", "proxy.config.net.keep_alive_shed_threshold updated to %d", global_config.keep_alive_shed_threshold);
+  Debug("net_queue", "proxy.config.net.keep_alive_shed_min_timeout updated to %d", global_config.keep_alive_shed_min_timeout);
+  Debug("net_queue", "proxy.config.net.max_io_per_loop updated to %d", global_config.max_io_per_loop);
 }
 
 //
@@ -377,6 +398,32 @@ NetHandler::process_enabled_list()
   }
 }
 
+// The I/O callbacks run from the poll rather than from EThread::process_event(), so they are timed
+// here for the stall watchdog. The continuation of the VIO is reported, that is whose handler runs.
+static inline void
+net_read_io_timed(NetHandler *nh, UnixNetVConnection *vc, EThread *t)
+{
+  if (thread_handler_stall_mseconds > 0) {
+    ink_hrtime start = t->dispatch_begin(vc->read.vio.cont ? vc->read.vio.cont : vc);
+    vc->net_read_io(nh, t);
+    t->dispatch_end(start);
+  } else {
+    vc->net_read_io(nh, t);
+  }
+}
+
+static inline void
+write_to_net_timed(NetHandler *nh, UnixNetVConnection *vc, EThread *t)
+{
+  if (thread_handler_stall_mseconds > 0) {
+    ink_hrtime start = t->dispatch_begin(vc->write.vio.cont ? vc->write.vio.cont : vc);
+    write_to_net(nh, vc, t);
+    t->dispatch_end(start);
+  } else {
+    write_to_net(nh, vc, t);
+  }
+}
+
 //
 // Walk through the ready list
 //
@@ -386,14 +433,21 @@ NetHandler::process_ready_list()
   UnixNetVConnection *vc = nullptr;
 
 #if defined(USE_EDGE_TRIGGER)
+  // A connection that still has data after its I/O is queued again at the tail, so with a budget every
+  // ready connection gets a turn before one gets a second. Whatever is left over is handled on the next
+  // pass, which does not wait in the poll while the ready lists are not empty.
+  uint32_t budget = config.max_io_per_loop;
+  uint32_t nio    = 0;
+
   // UnixNetVConnection *
-  while ((vc = read_ready_list.dequeue())) {
+  while ((budget == 0 || nio < budget) && (vc = read_ready_list.dequeue())) {
     // Initialize the thread-local continuation flags
     set_cont_flags(vc->control_flags);
     if (vc->closed) {
       free_netvc(vc);
     } else if (vc->read.enabled && vc->read.triggered) {
-      vc->net_read_io(this, this->thread);
+      net_read_io_timed(this, vc, this->thread);
+      ++nio;
     } else if (!vc->read.enabled) {
       read_ready_list.remove(vc);
 #if defined(solaris)
@@ -405,12 +459,18 @@ NetHandler::process_ready_list()
 #endif
     }
   }
-  while ((vc = write_ready_list.dequeue())) {
+  if (!read_ready_list.empty()) {
+    NET_INCREMENT_DYN_STAT(net_io_budget_deferred_stat);
+  }
+
+  nio = 0;
+  while ((budget == 0 || nio < budget) && (vc = write_ready_list.dequeue())) {
     set_cont_flags(vc->control_flags);
     if (vc->closed) {
       free_netvc(vc);
     } else if (vc->write.enabled && vc->write.triggered) {
-      write_to_net(this, vc, this->thread);
+      write_to_net_timed(this, vc, this->thread);
+      ++nio;
     } else if (!vc->write.enabled) {
       write_ready_list.remove(vc);
 #if defined(solaris)
@@ -422,13 +482,16 @@ NetHandler::process_ready_list()
 #endif
     }
   }
+  if (!write_ready_list.empty()) {
+    NET_INCREMENT_DYN_STAT(net_io_budget_deferred_stat);
+  }
 #else  /* !USE_EDGE_TRIGGER */
   while ((vc = read_ready_list.dequeue())) {
     set_cont_flags(vc->control_flags);
     if (vc->closed)
       free_netvc(vc);
     else if (vc->read.enabled && vc->read.triggered)
-      vc->net_read_io(this, this->thread);
+      net_read_io_timed(this, vc, this->thread);
     else if (!vc->read.enabled)
       vc->ep.modify(-EVENTIO_READ);
   }
@@ -437,7 +500,7 @@ NetHandler::process_ready_list()
     if (vc->closed)
       free_netvc(vc);
     else if (vc->write.enabled && vc->write.triggered)
-      write_to_net(this, vc, this->thread);
+      write_to_net_timed(this, vc, this->thread);
     else if (!vc->write.enabled)
       vc->ep.modify(-EVENTIO_WRITE);
   }
@@ -490,6 +553,9 @@ NetHandler::waitForActivity(ink_hrtime timeout)
       }
       if (get_ev_events(pd, x) & (EVENTIO_READ | EVENTIO_ERROR)) {
         vc->read.triggered = 1;
+#ifdef EVENTIO_HANGUP
+        vc->read.hangup = (get_ev_events(pd, x) & (EVENTIO_HANGUP | EVENTIO_ERROR)) != 0;
+#endif
         if (!read_ready_list.in(vc)) {
           read_ready_list.enqueue(vc);
         } else if (get_ev_events(pd, x) & EVENTIO_ERROR) {
@@ -528,6 +594,11 @@ NetHandler::waitForActivity(ink_hrtime timeout)
 
   process_ready_list();
 
+#if TS_USE_TLS_ASYNC
+  // Submit the crypto operations of every handshake that paused during this pass together.
+  SSLAsyncBatchFlush();
+#endif
+
   return EVENT_CONT;
 }
 
@@ -620,7 +691,9 @@ NetHandler::manage_keep_alive_queue()
   int total_idle_count        = 0;
   for (UnixNetVConnection *vc = keep_alive_queue.head; vc != nullptr; vc = vc_next) {
     vc_next = vc->keep_alive_queue_link.next;
-    _close_vc(vc, now, handle_event, closed, total_idle_time, total_idle_count);
+    if (_close_vc(vc, now, handle_event, closed, total_idle_time, total_idle_count)) {
+      NET_INCREMENT_DYN_STAT(net_connections_shed_max_connections_stat);
+    }
 
     total_connections_in = active_queue_size + keep_alive_queue_size;
     if (total_connections_in <= max_connections_per_thread_in) {
@@ -636,15 +709,89 @@ NetHandler::manage_keep_alive_queue()
 }
 
 void
+NetHandler::update_pressure()
+{
+  int64_t open = 0;
+  NET_READ_GLOBAL_DYN_SUM(net_connections_currently_open_stat, open);
+  int fd_pct  = net_connections_throttle > 0 ? static_cast<int>(std::max<int64_t>(open, 0) * 100 / net_connections_throttle) : 0;
+  int mem_pct = net_memory_usage_pct;
+
+  if (mem_pct > fd_pct) {
+    pressure        = mem_pct;
+    pressure_reason = SHED_MEMORY_PRESSURE;
+  } else {
+    pressure        = fd_pct;
+    pressure_reason = SHED_FD_PRESSURE;
+  }
+}
+
+void
+NetHandler::shed_keep_alive_queue()
+{
+  const int threshold = config.keep_alive_shed_threshold;
+
+  if (threshold <= 0 || pressure < threshold || keep_alive_queue_size == 0) {
+    return;
+  }
+
+  // How far past the threshold we are, as a fraction of the distance to 100%. The keep-alive timeout of
+  // each connection is scaled down by that fraction, to no less than the configured minimum.
+  const int over               = std::min(pressure, 100) - threshold;
+  const int span               = 100 - threshold;
+  const ink_hrtime min_timeout = HRTIME_SECONDS(config.keep_alive_shed_min_timeout);
+  const bool memory            = pressure_reason == SHED_MEMORY_PRESSURE;
+  ink_hrtime now               = Thread::get_hrtime();
+  UnixNetVConnection *vc_next  = nullptr;
+  int closed                   = 0;
+  int handle_event             = 0;
+  int total_idle_time          = 0;
+  int total_idle_count         = 0;
+  int shed                     = 0;
+
+  for (UnixNetVConnection *vc = keep_alive_queue.head; vc != nullptr; vc = vc_next) {
+    vc_next = vc->keep_alive_queue_link.next;
+    if (vc->inactivity_timeout_in == 0) {
+      continue;
+    }
+    const bool multiplexed = vc->get_is_multiplexed();
+    ink_hrtime timeout     = span > 0 ? vc->inactivity_timeout_in - (vc->inactivity_timeout_in * over) / span : 0;
+    // An idle multiplexed session pins far more memory (header tables, stream state) than an idle
+    // HTTP/1 connection, so it goes first.
+    if (multiplexed) {
+      timeout /= 2;
+    }
+    timeout = std::max(timeout, min_timeout);
+
+    ink_hrtime idle = now - (vc->next_inactivity_timeout_at - vc->inactivity_timeout_in);
+    if (idle < timeout) {
+      continue;
+    }
+    if (_close_vc(vc, now, handle_event, closed, total_idle_time, total_idle_count)) {
+      NET_INCREMENT_DYN_STAT(memory ? net_connections_shed_memory_pressure_stat : net_connections_shed_fd_pressure_stat);
+      if (multiplexed) {
+        NET_INCREMENT_DYN_STAT(net_connections_shed_multiplexed_stat);
+      }
+      ++shed;
+    }
+  }
+
+  if (shed > 0) {
+    Debug("net_queue", "shed %d keep-alive connections, %s pressure: %d%% threshold: %d%% remaining idle: %d", shed,
+          memory ? "memory" : "fd", pressure, threshold, keep_alive_queue_size);
+    check_pressure_shedding_warning(pressure_reason, pressure);
+  }
+}
+
+bool
 NetHandler::_close_vc(UnixNetVConnection *vc, ink_hrtime now, int &handle_event, int &closed, int &total_idle_time,
                       int &total_idle_count)
 {
   if (vc->thread != this_ethread()) {
-    return;
+    return false;
   }
   MUTEX_TRY_LOCK(lock, vc->mutex, this_ethread());
   if (!lock.is_locked()) {
-    return;
+    return false;
   }
   ink_hrtime diff = (now - (vc->next_inactivity_timeout_at - vc->inactivity_timeout_in)) / HRTIME_SECOND;
   if (diff > 0) {
@@ -668,6 +815,7 @@ NetHandler::_close_vc(UnixNetVConnection *vc, ink_hrtime now, int &handle_event,
       ++handle_event;
     }
   }
+  return true;
 }
 
 void
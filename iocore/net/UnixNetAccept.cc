@@ -21,7 +21,10 @@
   limitations under the License.
  */
 
+#include <set>
+
 #include <tscore/TSSystemState.h>
+#include <tscore/TestBox.h>
 
 #include "P_Net.h"
 
@@ -200,11 +203,30 @@ NetAccept::init_accept(EThread *t)
   t->schedule_every(this, period);
 }
 
+#if defined(SO_INCOMING_CPU)
+// The CPU @a t is bound to, or -1 if it may run anywhere. With several CPUs in the mask the first
+// one is used, connections still stay within the thread's cache domain.
+static int
+thread_incoming_cpu(EThread *t)
+{
+  cpu_set_t set;
+
+  CPU_ZERO(&set);
+  if (pthread_getaffinity_np(t->tid, sizeof(set), &set) != 0 || CPU_COUNT(&set) >= ink_number_of_processors()) {
+    return -1;
+  }
+  for (int cpu = 0; cpu < CPU_SETSIZE; ++cpu) {
+    if (CPU_ISSET(cpu, &set)) {
+      return cpu;
+    }
+  }
+  return -1;
+}
+#endif
+
 void
 NetAccept::init_accept_per_thread()
 {
-  int i, n;
-
   ink_assert(opt.etype >= 0);
 
   if (do_listen(NON_BLOCKING)) {
@@ -218,13 +240,26 @@ NetAccept::init_accept_per_thread()
   }
 
   period = -HRTIME_MSECONDS(net_accept_period);
-  n      = eventProcessor.thread_group[opt.etype]._count;
+  int n  = eventProcessor.thread_group[opt.etype]._count;
 
-  for (i = 0; i < n; i++) {
-    NetAccept *a       = (i < n - 1) ? clone() : this;
-    EThread *t         = eventProcessor.thread_group[opt.etype]._thread[i];
+  std::vector<NetAccept *> accepts = clone_per_thread(n, listen_per_thread && opt.etype == ET_NET);
+
+  // There are more accepts than threads only if more sockets were passed down than there are
+  // threads, every one of them gets connections so every one is watched.
+  for (size_t i = 0; i < accepts.size(); i++) {
+    NetAccept *a       = accepts[i];
+    EThread *t         = eventProcessor.thread_group[opt.etype]._thread[i % n];
     PollDescriptor *pd = get_PollDescriptor(t);
 
+#if defined(SO_INCOMING_CPU)
+    if (listen_per_thread && opt.etype == ET_NET && !a->shared_fd) {
+      if (int cpu = thread_incoming_cpu(t); cpu >= 0) {
+        // Steer connections whose packets arrive on the thread's CPU to this socket.
+        (void)safe_setsockopt(a->server.fd, SOL_SOCKET, SO_INCOMING_CPU, reinterpret_cast<char *>(&cpu), sizeof(cpu));
+      }
+    }
+#endif
+
     if (a->ep.start(pd, a, EVENTIO_READ) < 0) {
       Warning("[NetAccept::init_accept_per_thread]:error starting EventIO");
     }
@@ -234,6 +269,41 @@ NetAccept::init_accept_per_thread()
   }
 }
 
+std::vector<NetAccept *>
+NetAccept::clone_per_thread(int n, bool reuseport)
+{
+  std::vector<NetAccept *> accepts;
+  size_t count = n;
+
+  if (reuseport) {
+    count = std::max(count, opt.thread_fds.size() + 1);
+  }
+
+  // With @a reuseport every accept gets its own SO_REUSEPORT socket for the port, so the kernel
+  // spreads connections without an accept handoff or a shared queue. Sockets passed down in
+  // opt.thread_fds are used first, then new ones are opened. This accept comes last and keeps the
+  // socket it already has. If a socket can't be opened the remaining accepts share that one
+  // instead, only this NetAccept closes it.
+  for (size_t i = 0; i < count; i++) {
+    NetAccept *a = (i < count - 1) ? clone() : this;
+
+    a->shared_fd = (a != this);
+    if (reuseport && a != this) {
+      a->server.fd = i < opt.thread_fds.size() ? opt.thread_fds[i] : NO_FD;
+      if (a->do_listen(NON_BLOCKING) == 0) {
+        a->shared_fd = false;
+      } else {
+        a->server.fd = server.fd;
+        reuseport    = false;
+        Warning("unable to open a listen socket per thread for port %d, the remaining threads share one",
+                ats_ip_port_host_order(&server.accept_addr));
+      }
+    }
+    accepts.push_back(a);
+  }
+  return accepts;
+}
+
 void
 NetAccept::stop_accept()
 {
@@ -363,6 +433,9 @@ NetAccept::acceptEvent(int event, void *ep)
   MUTEX_TRY_LOCK(lock, m, e->ethread);
   if (lock.is_locked()) {
     if (action_->cancelled) {
+      if (!shared_fd) {
+        server.close();
+      }
       e->cancel();
       NET_DECREMENT_DYN_STAT(net_accepts_currently_open_stat);
       delete this;
@@ -399,6 +472,12 @@ NetAccept::acceptFastEvent(int event, void *ep)
   UnixNetVConnection *vc = nullptr;
   int loop               = accept_till_done;
 
+  // Cancelling the action only closes the socket of the original NetAccept, a socket opened per
+  // thread is closed here.
+  if (listen_per_thread && action_->cancelled) {
+    goto Lerror;
+  }
+
   do {
     if (!opt.backdoor && check_net_throttle(ACCEPT)) {
       ifd = NO_FD;
@@ -499,7 +578,9 @@ Ldone:
   return EVENT_CONT;
 
 Lerror:
-  server.close();
+  if (!shared_fd) {
+    server.close();
+  }
   e->cancel();
   NET_DECREMENT_DYN_STAT(net_accepts_currently_open_stat);
   delete this;
@@ -555,3 +636,61 @@ NetAccept::getNetProcessor() const
 {
   return &netProcessor;
 }
+
+#if TS_HAS_TESTS && defined(SO_REUSEPORT)
+
+REGRESSION_TEST(NetAccept_ClonePerThread)(RegressionTest *t, int /* atype ATS_UNUSED */, int *pstatus)
+{
+  TestBox box(t, pstatus);
+  box = REGRESSION_TEST_PASSED;
+
+  // Server::listen() only sets SO_REUSEPORT with per thread listening on.
+  int saved_listen_per_thread = listen_per_thread;
+  listen_per_thread           = 1;
+
+  NetProcessor::AcceptOptions opt;
+  NetAccept *na = new NetAccept(opt);
+  na->server.accept_addr.setToLoopback(AF_INET);
+
+  if (na->do_listen(NON_BLOCKING) != 0) {
+    box.check(false, "unable to listen on a loopback port");
+    listen_per_thread = saved_listen_per_thread;
+    delete na;
+    return;
+  }
+  // Every socket goes on the port the first one got.
+  na->server.accept_addr.port() = na->server.addr.port();
+
+  // A socket passed down as traffic_manager does.
+  Server passed;
+  ats_ip_copy(&passed.accept_addr, &na->server.accept_addr);
+  box.check(passed.listen(NON_BLOCKING, opt) == 0, "unable to open the passed socket");
+  na->opt.thread_fds.push_back(passed.fd);
+  passed.fd = NO_FD; // Closed with the accept that takes it.
+
+  std::vector<NetAccept *> accepts = na->clone_per_thread(3, true);
+  listen_per_thread                = saved_listen_per_thread;
+
+  box.check(accepts.size() == 3, "expected 3 accepts, got %zu", accepts.size());
+  box.check(accepts.back() == na, "the original accept is not the last one");
+  box.check(accepts.front()->server.fd == passed.fd, "the passed socket is not used first");
+
+  std::set<int> fds;
+  for (NetAccept *a : accepts) {
+    IpEndpoint local;
+    int namelen = sizeof(local);
+
+    fds.insert(a->server.fd);
+    box.check(!a->shared_fd, "accept %p shares its socket", a);
+    box.check(safe_getsockname(a->server.fd, &local.sa, &namelen) == 0 && local.port() == na->server.accept_addr.port(),
+              "socket %d is not on port %d", a->server.fd, ats_ip_port_host_order(&na->server.accept_addr));
+  }
+  box.check(fds.size() == accepts.size(), "expected %zu distinct sockets, got %zu", accepts.size(), fds.size());
+
+  for (NetAccept *a : accepts) {
+    a->server.close();
+    delete a;
+  }
+}
+
+#endif // TS_HAS_TESTS && SO_REUSEPORT
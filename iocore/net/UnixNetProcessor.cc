@@ -53,6 +53,7 @@ NetProcessor::AcceptOptions::reset()
   f_inbound_transparent = false;
   f_mptcp               = false;
   f_proxy_protocol      = false;
+  thread_fds.clear();
   return *this;
 }
 
@@ -137,7 +138,7 @@ UnixNetProcessor::accept_internal(Continuation *cont, int fd, AcceptOptions cons
   na->action_->server = &na->server;
 
   if (opt.frequent_accept) { // true
-    if (accept_threads > 0) {
+    if (accept_threads > 0 && !listen_per_thread) {
       na->init_accept_loop();
     } else {
       na->init_accept_per_thread();
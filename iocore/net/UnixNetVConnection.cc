@@ -27,6 +27,8 @@
 #include "Log.h"
 
 #include <termios.h>
+#include <algorithm>
+#include <cstddef>
 
 #define STATE_VIO_OFFSET ((uintptr_t) & ((NetState *)0)->vio)
 #define STATE_FROM_VIO(_x) ((NetState *)(((char *)(_x)) - STATE_VIO_OFFSET))
@@ -34,6 +36,40 @@
 // Global
 ClassAllocator<UnixNetVConnection> netVCAllocator("netVCAllocator");
 
+#if defined(__linux__) && HAVE_STRUCT_TCP_INFO && defined(TCP_INFO) && defined(TCP_NOTSENT_LOWAT)
+#define TS_USE_TCP_WRITE_SIZING 1
+
+// <netinet/tcp.h> ends struct tcp_info at tcpi_total_retrans, the kernel appends more fields after it
+// (see <linux/tcp.h>, which can't be included alongside). Their offsets are kernel ABI, older kernels
+// return a shorter struct, so each one is only read if the returned length covers it.
+static constexpr size_t TCPI_NOTSENT_BYTES_OFFSET = 144; ///< uint32_t, Linux 4.6
+static constexpr size_t TCPI_MIN_RTT_OFFSET       = 148; ///< uint32_t, Linux 4.6
+static constexpr size_t TCPI_DELIVERY_RATE_OFFSET = 160; ///< uint64_t, Linux 4.9
+
+static_assert(offsetof(struct tcp_info, tcpi_total_retrans) == 100, "struct tcp_info does not match the kernel layout");
+
+union TcpInfo {
+  struct tcp_info base;
+  char raw[TCPI_DELIVERY_RATE_OFFSET + sizeof(uint64_t)];
+
+  /// Get the field of type @a T at @a offset, if the @a len bytes returned by the kernel cover it.
+  template <typename T>
+  bool
+  get(size_t offset, int len, T &value) const
+  {
+    if (offset + sizeof(T) > static_cast<size_t>(len)) {
+      return false;
+    }
+    memcpy(&value, raw + offset, sizeof(T));
+    return true;
+  }
+};
+
+// Bounds of the unsent queue target when sizing writes from TCP_INFO.
+static constexpr int64_t TCP_WRITE_SIZING_MIN = 16 * 1024;
+static constexpr int64_t TCP_WRITE_SIZING_MAX = 4 * 1024 * 1024;
+#endif
+
 //
 // Reschedule a UnixNetVConnection by moving it
 // onto or off of the ready_list
@@ -206,6 +242,11 @@ read_from_net(NetHandler *nh, UnixNetVConnection *vc, EThread *thread)
     return;
   }
 
+  if (s->splice) {
+    s->splice->read_from_net(nh);
+    return;
+  }
+
   MIOBufferAccessor &buf = s->vio.buffer;
   ink_assert(buf.writer());
 
@@ -285,6 +326,15 @@ read_from_net(NetHandler *nh, UnixNetVConnection *vc, EThread *thread)
     }
     NET_SUM_DYN_STAT(net_read_bytes_stat, r);
 
+#if defined(USE_EDGE_TRIGGER) && defined(EVENTIO_HANGUP)
+    // A short read emptied the socket and any data arriving later raises a new edge, so there is no
+    // need for another read just to see EAGAIN. A pending shutdown or error raises no new edge, in
+    // that case keep reading until the kernel reports it.
+    if (r < toread && !vc->read.hangup) {
+      vc->read.triggered = 0;
+    }
+#endif
+
     // Add data to buffer and signal continuation.
     buf.writer()->fill(r);
 #ifdef DEBUG
@@ -402,6 +452,11 @@ write_to_net_io(NetHandler *nh, UnixNetVConnection *vc, EThread *thread)
     return;
   }
 
+  if (s->splice) {
+    s->splice->write_to_net(nh);
+    return;
+  }
+
   // If there is nothing to do, disable
   int64_t ntodo = s->vio.ntodo();
   if (ntodo <= 0) {
@@ -448,12 +503,23 @@ write_to_net_io(NetHandler *nh, UnixNetVConnection *vc, EThread *thread)
     return;
   }
 
+  // Only hand the kernel what the connection drains in about a round trip, the rest waits here
+  // where HTTP/2 can still reorder it.
+  if (net_tcp_write_sizing) {
+    int64_t budget = vc->tcp_write_budget();
+    if (budget >= 0 && budget < towrite) {
+      towrite = budget;
+      NET_INCREMENT_DYN_STAT(net_tcp_write_sized_stat);
+    }
+  }
+
   int needs             = 0;
   int64_t total_written = 0;
   int64_t r             = vc->load_buffer_and_write(towrite, buf, total_written, needs);
 
   if (total_written > 0) {
     NET_SUM_DYN_STAT(net_write_bytes_stat, total_written);
+    vc->tcp_sizing.unsent += total_written;
     s->vio.ndone += total_written;
     net_activity(vc, thread);
   }
@@ -536,6 +602,62 @@ write_to_net_io(NetHandler *nh, UnixNetVConnection *vc, EThread *thread)
   }
 }
 
+int64_t
+UnixNetVConnection::tcp_write_budget()
+{
+#if TS_USE_TCP_WRITE_SIZING
+  TcpWriteSizing &ts = tcp_sizing;
+  ink_hrtime now     = Thread::get_hrtime();
+
+  if (ts.unavailable || con.sock_type != SOCK_STREAM) {
+    return -1;
+  }
+
+  if (now >= ts.next_sample) {
+    TcpInfo info;
+    int len                = sizeof(info);
+    uint32_t notsent_bytes = 0;
+    uint32_t min_rtt       = 0;
+    uint64_t delivery_rate = 0;
+
+    if (safe_getsockopt(con.fd, IPPROTO_TCP, TCP_INFO, info.raw, &len) < 0 ||
+        // tcpi_snd_cwnd is the last of the base fields used here.
+        len < static_cast<int>(offsetof(struct tcp_info, tcpi_snd_cwnd) + sizeof(info.base.tcpi_snd_cwnd)) ||
+        !info.get(TCPI_NOTSENT_BYTES_OFFSET, len, notsent_bytes)) {
+      ts.unavailable = true;
+      return -1;
+    }
+
+    // One window in flight is the least the connection drains per round trip, the delivery rate
+    // over the minimum round trip is a better estimate once the kernel has one.
+    int64_t bdp = static_cast<int64_t>(info.base.tcpi_snd_cwnd) * info.base.tcpi_snd_mss;
+    if (info.get(TCPI_MIN_RTT_OFFSET, len, min_rtt) && info.get(TCPI_DELIVERY_RATE_OFFSET, len, delivery_rate) && min_rtt > 0) {
+      bdp = std::max<int64_t>(bdp, delivery_rate * min_rtt / 1000000);
+    }
+
+    int64_t floor  = std::max<int64_t>(net_sock_notsent_lowat, TCP_WRITE_SIZING_MIN);
+    ts.target      = std::clamp<int64_t>(bdp, floor, std::max(floor, TCP_WRITE_SIZING_MAX));
+    ts.unsent      = notsent_bytes;
+    ts.mss         = std::max<int64_t>(info.base.tcpi_snd_mss, 1);
+    ts.next_sample = now + std::max(HRTIME_USECONDS(info.base.tcpi_rtt), HRTIME_MSECONDS(1));
+
+    // Keep the low water mark close to the target, without a system call for every small change.
+    if (ts.lowat == 0 || ts.target > ts.lowat + ts.lowat / 4 || ts.target < ts.lowat - ts.lowat / 4) {
+      int lowat = static_cast<int>(ts.target);
+      if (safe_setsockopt(con.fd, IPPROTO_TCP, TCP_NOTSENT_LOWAT, reinterpret_cast<char *>(&lowat), sizeof(lowat)) == 0) {
+        ts.lowat = lowat;
+      }
+    }
+  }
+
+  // Always offer at least a segment. If the queue is past the low water mark the kernel refuses it,
+  // which arms the write ready notification for when the queue drains.
+  return std::max(ts.target - ts.unsent, ts.mss);
+#else
+  return -1;
+#endif
+}
+
 bool
 UnixNetVConnection::get_data(int id, void *data)
 {
@@ -901,11 +1023,15 @@ UnixNetVConnection::load_buffer_and_write(int64_t towrite, MIOBufferAccessor &bu
   int64_t r                  = 0;
   int64_t try_to_write       = 0;
   IOBufferReader *tmp_reader = buf.reader()->clone();
+  ProxyMutex *mutex          = thread->mutex.get();
 
   do {
     IOVec tiovec[NET_MAX_IOV];
-    unsigned niov = 0;
-    try_to_write  = 0;
+    unsigned niov               = 0;
+    IOBufferData *sendfile_data = nullptr;
+    off_t sendfile_from         = 0;
+    bool lost                   = false;
+    try_to_write                = 0;
 
     while (niov < NET_MAX_IOV) {
       int64_t wavail = towrite - total_written;
@@ -925,6 +1051,19 @@ UnixNetVConnection::load_buffer_and_write(int64_t towrite, MIOBufferAccessor &bu
         break;
       }
 
+      // Bytes mapped from a file are sent with sendfile(), in a call of their own. Once the writer of
+      // the file gets close to them they are copied, and if it already overwrote them they are never sent.
+      IOBufferData *data = tmp_reader->block->data.get();
+      if (data->_mem_type == MMAPPED && !data->_map_guard.safe() && !tmp_reader->block->copy_mapped_data()) {
+        lost = true;
+        break;
+      }
+      data        = tmp_reader->block->data.get();
+      bool mapped = data->_mem_type == MMAPPED;
+      if (mapped && niov > 0) {
+        break;
+      }
+
       // build an iov entry
       tiovec[niov].iov_len  = len;
       tiovec[niov].iov_base = tmp_reader->start();
@@ -932,8 +1071,18 @@ UnixNetVConnection::load_buffer_and_write(int64_t towrite, MIOBufferAccessor &bu
 
       try_to_write += len;
       tmp_reader->consume(len);
+
+      if (mapped) {
+        sendfile_data = data;
+        sendfile_from = data->_fd_offset + (static_cast<char *>(tiovec[0].iov_base) - data->_data);
+        break;
+      }
     }
 
+    if (lost && niov == 0) {
+      r = -EIO;
+      break;
+    }
     ink_assert(niov > 0);
     ink_assert(niov <= countof(tiovec));
 
@@ -962,6 +1111,18 @@ UnixNetVConnection::load_buffer_and_write(int64_t towrite, MIOBufferAccessor &bu
         this->con.is_connected = true;
       }
 
+    } else if (sendfile_data) {
+      r = socketManager.sendfile(con.fd, sendfile_data->_fd, sendfile_from, try_to_write);
+      if (r == -EINVAL || r == -ENOSYS) {
+        // The file does not support sendfile(), the mapping holds the same bytes.
+        r = socketManager.writev(con.fd, &tiovec[0], niov);
+      } else if (r > 0) {
+        NET_SUM_DYN_STAT(net_sendfile_bytes_stat, r);
+      }
+      if (r > 0 && !sendfile_data->_map_guard.intact()) {
+        // Overwritten while being sent, what went out can not be trusted.
+        r = -EIO;
+      }
     } else {
       r = socketManager.writev(con.fd, &tiovec[0], niov);
     }
@@ -971,7 +1132,6 @@ UnixNetVConnection::load_buffer_and_write(int64_t towrite, MIOBufferAccessor &bu
       total_written += r;
     }
 
-    ProxyMutex *mutex = thread->mutex.get();
     NET_INCREMENT_DYN_STAT(net_calls_to_write_stat);
   } while (r == try_to_write && total_written < towrite);
 
@@ -37,6 +37,12 @@
 #include "P_Net.h"
 #include "P_UDPNet.h"
 
+#include <atomic>
+
+#if defined(linux)
+#include <netinet/udp.h>
+#endif
+
 using UDPNetContHandler = int (UDPNetHandler::*)(int, void *);
 
 inkcoreapi ClassAllocator<UDPPacketInternal> udpPacketAllocator("udpPacketAllocator");
@@ -52,6 +58,8 @@ UDPNetProcessor &udpNet = udpNetInternal;
 int32_t g_udp_periodicCleanupSlots;
 int32_t g_udp_periodicFreeCancelledPkts;
 int32_t g_udp_numSendRetries;
+int32_t g_udp_enableGSO;
+int32_t g_udp_enableGRO;
 
 //
 // Public functions
@@ -60,6 +68,9 @@ int32_t g_udp_numSendRetries;
 int G_bwGrapherFd;
 sockaddr_in6 G_bwGrapherLoc;
 
+// Set once UDP_SEGMENT is known to work, cleared if the kernel or device rejects it later.
+static std::atomic<bool> udp_gso_supported{false};
+
 void
 initialize_thread_for_udp_net(EThread *thread)
 {
@@ -91,6 +102,10 @@ initialize_thread_for_udp_net(EThread *thread)
   REC_ReadConfigInt32(g_udp_numSendRetries, "proxy.config.udp.send_retries");
   g_udp_numSendRetries = g_udp_numSendRetries < 0 ? 0 : g_udp_numSendRetries;
 
+  // Segmentation offload, the kernel splits (GSO) or coalesces (GRO) runs of equal sized datagrams.
+  REC_ReadConfigInt32(g_udp_enableGSO, "proxy.config.udp.enable_gso");
+  REC_ReadConfigInt32(g_udp_enableGRO, "proxy.config.udp.enable_gro");
+
   thread->set_tail_handler(nh);
   thread->ep = (EventIO *)ats_malloc(sizeof(EventIO));
   new (thread->ep) EventIO();
@@ -112,6 +127,21 @@ UDPNetProcessorInternal::start(int n_upd_threads, size_t stacksize)
   pollCont_offset      = eventProcessor.allocate(sizeof(PollCont));
   udpNetHandler_offset = eventProcessor.allocate(sizeof(UDPNetHandler));
 
+#if defined(UDP_SEGMENT)
+  {
+    // GSO needs kernel support (4.18+), which can only be found out from a socket.
+    int fd = socketManager.socket(AF_INET, SOCK_DGRAM, 0);
+    int segment;
+    int len = sizeof(segment);
+
+    udp_gso_supported = fd >= 0 && safe_getsockopt(fd, SOL_UDP, UDP_SEGMENT, reinterpret_cast<char *>(&segment), &len) == 0;
+    if (fd >= 0) {
+      socketManager.close(fd);
+    }
+    Debug("udpnet", "UDP GSO is %s", udp_gso_supported ? "supported" : "not supported");
+  }
+#endif
+
   ET_UDP = eventProcessor.register_event_type("ET_UDP");
   eventProcessor.schedule_spawn(&initialize_thread_for_udp_net, ET_UDP);
   eventProcessor.spawn_event_threads(ET_UDP, n_upd_threads, stacksize);
@@ -119,6 +149,128 @@ UDPNetProcessorInternal::start(int n_upd_threads, size_t stacksize)
   return 0;
 }
 
+// Pick up the local address of a received datagram, and the GRO segment size if the kernel
+// coalesced several datagrams (0 if not), from the control messages in @a msg.
+static void
+udp_read_control(struct msghdr *msg, sockaddr_in6 &toaddr, int &segment_size)
+{
+  segment_size = 0;
+  for (auto cmsg = CMSG_FIRSTHDR(msg); cmsg != nullptr; cmsg = CMSG_NXTHDR(msg, cmsg)) {
+    switch (cmsg->cmsg_type) {
+#ifdef IP_PKTINFO
+    case IP_PKTINFO:
+      if (cmsg->cmsg_level == IPPROTO_IP) {
+        struct in_pktinfo *pktinfo                                = reinterpret_cast<struct in_pktinfo *>(CMSG_DATA(cmsg));
+        reinterpret_cast<sockaddr_in *>(&toaddr)->sin_addr.s_addr = pktinfo->ipi_addr.s_addr;
+      }
+      break;
+#endif
+#ifdef IP_RECVDSTADDR
+    case IP_RECVDSTADDR:
+      if (cmsg->cmsg_level == IPPROTO_IP) {
+        struct in_addr *addr                                      = reinterpret_cast<struct in_addr *>(CMSG_DATA(cmsg));
+        reinterpret_cast<sockaddr_in *>(&toaddr)->sin_addr.s_addr = addr->s_addr;
+      }
+      break;
+#endif
+#if defined(IPV6_PKTINFO) || defined(IPV6_RECVPKTINFO)
+    case IPV6_PKTINFO: // IPV6_RECVPKTINFO uses IPV6_PKTINFO too
+      if (cmsg->cmsg_level == IPPROTO_IPV6) {
+        struct in6_pktinfo *pktinfo = reinterpret_cast<struct in6_pktinfo *>(CMSG_DATA(cmsg));
+        memcpy(toaddr.sin6_addr.s6_addr, &pktinfo->ipi6_addr, 16);
+      }
+      break;
+#endif
+#if defined(UDP_GRO)
+    case UDP_GRO:
+      if (cmsg->cmsg_level == SOL_UDP) {
+        memcpy(&segment_size, CMSG_DATA(cmsg), sizeof(segment_size));
+      }
+      break;
+#endif
+    }
+  }
+}
+
+#if HAVE_RECVMMSG
+/**
+   Read up to UDP_RECV_BATCH datagrams per system call. Each datagram lands in a per thread scratch
+   slot big enough for the largest (GRO coalesced) datagram and is then copied into a block of its
+   own size, which is cheaper than a system call per datagram and wastes no buffer space on the
+   usual 1.2-1.5K QUIC packets.
+ */
+static int
+udp_read_batch(UnixUDPConnection *uc)
+{
+  static constexpr unsigned UDP_RECV_BATCH = 16;
+  static constexpr size_t UDP_RECV_SLOT    = 65536;
+  static thread_local char *scratch        = nullptr;
+
+  struct mmsghdr msgvec[UDP_RECV_BATCH];
+  struct iovec iov[UDP_RECV_BATCH];
+  sockaddr_in6 fromaddr[UDP_RECV_BATCH];
+  char cbuf[UDP_RECV_BATCH][128];
+  sockaddr_in6 localaddr;
+  int localaddr_len = sizeof(localaddr);
+  int total         = 0;
+  int r;
+
+  if (scratch == nullptr) {
+    scratch = static_cast<char *>(ats_malloc(UDP_RECV_BATCH * UDP_RECV_SLOT));
+  }
+  safe_getsockname(uc->getFd(), reinterpret_cast<struct sockaddr *>(&localaddr), &localaddr_len);
+
+  do {
+    for (unsigned i = 0; i < UDP_RECV_BATCH; ++i) {
+      iov[i].iov_base                 = scratch + i * UDP_RECV_SLOT;
+      iov[i].iov_len                  = UDP_RECV_SLOT;
+      msgvec[i].msg_hdr.msg_name       = &fromaddr[i];
+      msgvec[i].msg_hdr.msg_namelen    = sizeof(fromaddr[i]);
+      msgvec[i].msg_hdr.msg_iov        = &iov[i];
+      msgvec[i].msg_hdr.msg_iovlen     = 1;
+      msgvec[i].msg_hdr.msg_control    = cbuf[i];
+      msgvec[i].msg_hdr.msg_controllen = sizeof(cbuf[i]);
+      msgvec[i].msg_hdr.msg_flags      = 0;
+      msgvec[i].msg_len                = 0;
+    }
+
+    r = ::recvmmsg(uc->getFd(), msgvec, UDP_RECV_BATCH, MSG_DONTWAIT, nullptr);
+    if (r <= 0) {
+      break;
+    }
+
+    for (int i = 0; i < r; ++i) {
+      struct msghdr *msg = &msgvec[i].msg_hdr;
+      char *data         = static_cast<char *>(iov[i].iov_base);
+      int len            = msgvec[i].msg_len;
+      sockaddr_in6 toaddr;
+      int segment_size;
+
+      if (msg->msg_flags & MSG_TRUNC) {
+        Debug("udp-read", "The UDP packet is truncated");
+      }
+
+      toaddr = localaddr;
+      udp_read_control(msg, toaddr, segment_size);
+      if (segment_size <= 0) {
+        segment_size = len;
+      }
+
+      // A GRO datagram is a run of datagrams of segment_size bytes, the last one possibly shorter.
+      for (int offset = 0; offset < len; offset += segment_size) {
+        int seglen   = std::min(segment_size, len - offset);
+        UDPPacket *p = new_incoming_UDPPacket(ats_ip_sa_cast(&fromaddr[i]), ats_ip_sa_cast(&toaddr), data + offset, seglen);
+        p->setConnection(uc);
+        uc->inQueue.push((UDPPacketInternal *)p);
+        ++total;
+      }
+    }
+  } while (r == static_cast<int>(UDP_RECV_BATCH));
+
+  return total;
+}
+#endif
+
 void
 UDPNetProcessorInternal::udp_read_from_net(UDPNetHandler *nh, UDPConnection *xuc)
 {
@@ -126,8 +278,12 @@ UDPNetProcessorInternal::udp_read_from_net(UDPNetHandler *nh, UDPConnection *xuc
 
   // receive packet and queue onto UDPConnection.
   // don't call back connection at this time.
+  int iters = 0;
+
+#if HAVE_RECVMMSG
+  iters = udp_read_batch(uc);
+#else
   int64_t r;
-  int iters         = 0;
   unsigned max_niov = 32;
 
   struct msghdr msg;
@@ -169,6 +325,7 @@ UDPNetProcessorInternal::udp_read_from_net(UDPNetHandler *nh, UDPConnection *xuc
     sockaddr_in6 fromaddr;
     sockaddr_in6 toaddr;
     int toaddr_len = sizeof(toaddr);
+    int segment_size;
     char *cbuf[1024];
     msg.msg_name       = &fromaddr;
     msg.msg_namelen    = sizeof(fromaddr);
@@ -206,34 +363,7 @@ UDPNetProcessorInternal::udp_read_from_net(UDPNetHandler *nh, UDPConnection *xuc
     }
 
     safe_getsockname(xuc->getFd(), reinterpret_cast<struct sockaddr *>(&toaddr), &toaddr_len);
-    for (auto cmsg = CMSG_FIRSTHDR(&msg); cmsg != nullptr; cmsg = CMSG_NXTHDR(&msg, cmsg)) {
-      switch (cmsg->cmsg_type) {
-#ifdef IP_PKTINFO
-      case IP_PKTINFO:
-        if (cmsg->cmsg_level == IPPROTO_IP) {
-          struct in_pktinfo *pktinfo                                = reinterpret_cast<struct in_pktinfo *>(CMSG_DATA(cmsg));
-          reinterpret_cast<sockaddr_in *>(&toaddr)->sin_addr.s_addr = pktinfo->ipi_addr.s_addr;
-        }
-        break;
-#endif
-#ifdef IP_RECVDSTADDR
-      case IP_RECVDSTADDR:
-        if (cmsg->cmsg_level == IPPROTO_IP) {
-          struct in_addr *addr                                      = reinterpret_cast<struct in_addr *>(CMSG_DATA(cmsg));
-          reinterpret_cast<sockaddr_in *>(&toaddr)->sin_addr.s_addr = addr->s_addr;
-        }
-        break;
-#endif
-#if defined(IPV6_PKTINFO) || defined(IPV6_RECVPKTINFO)
-      case IPV6_PKTINFO: // IPV6_RECVPKTINFO uses IPV6_PKTINFO too
-        if (cmsg->cmsg_level == IPPROTO_IPV6) {
-          struct in6_pktinfo *pktinfo = reinterpret_cast<struct in6_pktinfo *>(CMSG_DATA(cmsg));
-          memcpy(toaddr.sin6_addr.s6_addr, &pktinfo->ipi6_addr, 16);
-        }
-        break;
-#endif
-      }
-    }
+    udp_read_control(&msg, toaddr, segment_size);
 
     // create packet
     UDPPacket *p = new_incoming_UDPPacket(ats_ip_sa_cast(&fromaddr), ats_ip_sa_cast(&toaddr), chain);
@@ -246,6 +376,7 @@ UDPNetProcessorInternal::udp_read_from_net(UDPNetHandler *nh, UDPConnection *xuc
     next_chain = nullptr;
     iters++;
   } while (r > 0);
+#endif
   if (iters >= 1) {
     Debug("udp-read", "read %d at a time", iters);
   }
@@ -735,7 +866,7 @@ HardError:
 }
 
 Action *
-UDPNetProcessor::UDPBind(Continuation *cont, sockaddr const *addr, int send_bufsize, int recv_bufsize)
+UDPNetProcessor::UDPBind(Continuation *cont, sockaddr const *addr, int send_bufsize, int recv_bufsize, EThread *thread)
 {
   int res              = 0;
   int fd               = -1;
@@ -802,6 +933,22 @@ UDPNetProcessor::UDPBind(Continuation *cont, sockaddr const *addr, int send_bufs
     goto Lerror;
   }
 
+#ifdef SO_REUSEPORT
+  if (thread != nullptr && (res = safe_setsockopt(fd, SOL_SOCKET, SO_REUSEPORT, SOCKOPT_ON, sizeof(int))) < 0) {
+    goto Lerror;
+  }
+#endif
+
+#if HAVE_RECVMMSG && defined(UDP_GRO)
+  // Only the batched read splits coalesced datagrams again.
+  if (g_udp_enableGRO) {
+    int enable = 1;
+    if (safe_setsockopt(fd, SOL_UDP, UDP_GRO, reinterpret_cast<char *>(&enable), sizeof(enable)) < 0) {
+      Debug("udpnet", "setsockopt for UDP_GRO failed");
+    }
+  }
+#endif
+
   if ((res = socketManager.ink_bind(fd, addr, ats_ip_size(addr))) < 0) {
     goto Lerror;
   }
@@ -823,7 +970,7 @@ UDPNetProcessor::UDPBind(Continuation *cont, sockaddr const *addr, int send_bufs
 
   Debug("udpnet", "UDPNetProcessor::UDPBind: %p fd=%d", n, fd);
   n->setBinding(&myaddr.sa);
-  n->bindToThread(cont);
+  n->bindToThread(cont, thread);
 
   pc = get_UDPPollCont(n->ethread);
   pd = pc->pollDescriptor;
@@ -906,6 +1053,8 @@ UDPQueue::SendPackets()
   int32_t bytesThisSlot = INT_MAX, bytesUsed = 0;
   int32_t bytesThisPipe, sentOne;
   int64_t pktLen;
+  UDPPacketInternal *packets[N_MAX_PACKETS];
+  int npackets = 0;
 
   bytesThisSlot = INT_MAX;
 
@@ -924,9 +1073,20 @@ sendPackets:
       goto next_pkt;
     }
 
-    SendUDPPacket(p, pktLen);
+    // Sent and freed in batches.
+    packets[npackets++] = p;
+    if (npackets == N_MAX_PACKETS) {
+      SendMultipleUDPPackets(packets, npackets);
+      npackets = 0;
+    }
     bytesUsed += pktLen;
     bytesThisPipe -= pktLen;
+    sentOne = true;
+    if (bytesThisPipe < 0) {
+      break;
+    }
+    continue;
+
   next_pkt:
     sentOne = true;
     p->free();
@@ -936,6 +1096,11 @@ sendPackets:
     }
   }
 
+  if (npackets > 0) {
+    SendMultipleUDPPackets(packets, npackets);
+    npackets = 0;
+  }
+
   bytesThisSlot -= bytesUsed;
 
   if ((bytesThisSlot > 0) && sentOne) {
@@ -1005,6 +1170,140 @@ UDPQueue::SendUDPPacket(UDPPacketInternal *p, int32_t /* pktLen ATS_UNUSED */)
   }
 }
 
+/**
+   Send and free @a packets. Consecutive packets for the same socket go out in one sendmmsg() call,
+   and with GSO consecutive packets for the same destination that have the same size (the last one
+   may be shorter) are handed to the kernel as a single datagram with UDP_SEGMENT set, which is
+   split after the stack has been traversed once.
+ */
+void
+UDPQueue::SendMultipleUDPPackets(UDPPacketInternal **packets, int n)
+{
+#if HAVE_SENDMMSG
+  static constexpr int N_MAX_IOV      = 512;
+  static constexpr int GSO_MAX_BYTES  = 65000; // below the UDP length limit, leaving room for headers
+  static constexpr int GSO_MAX_COUNT  = 64;    // UDP_MAX_SEGMENTS in the kernel
+  static constexpr size_t GSO_CMSG_SZ = CMSG_SPACE(sizeof(uint16_t));
+
+  struct mmsghdr msgvec[N_MAX_PACKETS];
+  struct iovec iov[N_MAX_IOV];
+  union {
+    char buf[GSO_CMSG_SZ];
+    struct cmsghdr align;
+  } cbuf[N_MAX_PACKETS];
+  int first[N_MAX_PACKETS + 1]; // first packet of each message, plus the end
+  uint16_t segment[N_MAX_PACKETS];
+  bool gso = g_udp_enableGSO && udp_gso_supported.load(std::memory_order_relaxed);
+  int i    = 0;
+
+  while (i < n) {
+    int fd   = packets[i]->conn->getFd();
+    int nmsg = 0;
+    int niov = 0;
+
+    // Build messages for the run of packets on this socket.
+    for (; i < n && packets[i]->conn->getFd() == fd; ++i) {
+      UDPPacketInternal *p = packets[i];
+      int len              = p->getPktLength();
+      int blocks           = 0;
+
+      for (IOBufferBlock *b = p->chain.get(); b != nullptr; b = b->next.get()) {
+        ++blocks;
+      }
+      if (niov + blocks > N_MAX_IOV) {
+        if (nmsg == 0) {
+          SendUDPPacket(p, len);
+          continue;
+        }
+        break;
+      }
+
+      p->conn->lastSentPktStartTime = p->delivery_time;
+      Debug("udp-send", "Sending %p", p);
+
+      struct msghdr *last = nmsg > 0 ? &msgvec[nmsg - 1].msg_hdr : nullptr;
+      int count           = nmsg > 0 ? i - first[nmsg - 1] : 0;
+      int bytes           = 0;
+      if (last) {
+        for (int k = first[nmsg - 1]; k < i; ++k) {
+          bytes += packets[k]->getPktLength();
+        }
+      }
+
+      if (gso && last && ats_ip_addr_port_eq(&p->to.sa, &packets[i - 1]->to.sa) && len <= segment[nmsg - 1] &&
+          packets[i - 1]->getPktLength() == segment[nmsg - 1] && count < GSO_MAX_COUNT && bytes + len <= GSO_MAX_BYTES) {
+        // Append to the previous message as one more segment.
+      } else {
+        struct msghdr *msg = &msgvec[nmsg].msg_hdr;
+        ink_zero(*msg);
+        msg->msg_name    = &p->to.sa;
+        msg->msg_namelen = ats_ip_size(p->to);
+        msg->msg_iov     = &iov[niov];
+        segment[nmsg]    = len;
+        first[nmsg]      = i;
+        ++nmsg;
+      }
+
+      for (IOBufferBlock *b = p->chain.get(); b != nullptr; b = b->next.get()) {
+        iov[niov].iov_base = b->start();
+        iov[niov].iov_len  = b->size();
+        ++niov;
+        ++msgvec[nmsg - 1].msg_hdr.msg_iovlen;
+      }
+    }
+    first[nmsg] = i;
+
+#if defined(UDP_SEGMENT)
+    for (int m = 0; m < nmsg; ++m) {
+      if (first[m + 1] - first[m] > 1) {
+        struct msghdr *msg = &msgvec[m].msg_hdr;
+        msg->msg_control    = cbuf[m].buf;
+        msg->msg_controllen = sizeof(cbuf[m].buf);
+
+        struct cmsghdr *cm = CMSG_FIRSTHDR(msg);
+        cm->cmsg_level     = SOL_UDP;
+        cm->cmsg_type      = UDP_SEGMENT;
+        cm->cmsg_len       = CMSG_LEN(sizeof(uint16_t));
+        memcpy(CMSG_DATA(cm), &segment[m], sizeof(uint16_t));
+      }
+    }
+#endif
+
+    // Send, retrying on EAGAIN like SendUDPPacket(). A message that fails is skipped.
+    int sent  = 0;
+    int tries = 0;
+    while (sent < nmsg) {
+      int r = ::sendmmsg(fd, &msgvec[sent], nmsg - sent, 0);
+      if (r > 0) {
+        sent += r;
+        continue;
+      }
+      if (errno == EAGAIN && (g_udp_numSendRetries == 0 || ++tries < g_udp_numSendRetries)) {
+        continue;
+      }
+      Debug("udp-send", "Error: %s (%d)", strerror(errno), errno);
+      if (msgvec[sent].msg_hdr.msg_control != nullptr && (errno == EIO || errno == EINVAL)) {
+        // The device or kernel can't segment for us after all, fall back to one packet per call.
+        Warning("UDP GSO failed (%s), disabling it", strerror(errno));
+        udp_gso_supported = false;
+        for (int k = first[sent]; k < first[sent + 1]; ++k) {
+          SendUDPPacket(packets[k], packets[k]->getPktLength());
+        }
+      }
+      ++sent;
+    }
+  }
+#else
+  for (int i = 0; i < n; ++i) {
+    SendUDPPacket(packets[i], packets[i]->getPktLength());
+  }
+#endif
+
+  for (int i = 0; i < n; ++i) {
+    packets[i]->free();
+  }
+}
+
 void
 UDPQueue::send(UDPPacket *p)
 {
@@ -101,6 +101,8 @@ QUICAltConnectionManager::_generate_next_alt_con_info()
 {
   QUICConnectionId conn_id;
   conn_id.randomize();
+  // Keep packets sent to any of our connection IDs on the thread that owns the connection.
+  conn_id.set_owner_tag(this->_qc->connection_id().owner_tag());
   QUICStatelessResetToken token(conn_id, this->_instance_id);
   AltConnectionInfo aci = {++this->_alt_quic_connection_id_seq_num, conn_id, token, {false}};
 
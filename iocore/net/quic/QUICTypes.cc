@@ -603,6 +603,18 @@ QUICConnectionId::randomize()
   this->_len = QUICConnectionId::SCID_LEN;
 }
 
+uint8_t
+QUICConnectionId::owner_tag() const
+{
+  return this->_id[0];
+}
+
+void
+QUICConnectionId::set_owner_tag(uint8_t tag)
+{
+  this->_id[0] = tag;
+}
+
 uint64_t
 QUICConnectionId::_hashcode() const
 {
@@ -265,6 +265,13 @@ public:
   bool is_zero() const;
   void randomize();
 
+  /*
+   * The first byte of a connection ID issued by a server names the thread that owns the connection,
+   * so that packets can be steered to that thread without looking the connection up first.
+   */
+  uint8_t owner_tag() const;
+  void set_owner_tag(uint8_t tag);
+
 private:
   uint64_t _hashcode() const;
   uint8_t _id[MAX_LENGTH];
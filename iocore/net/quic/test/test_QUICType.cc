@@ -75,4 +75,19 @@ TEST_CASE("QUICType", "[quic]")
     CHECK(memcmp(token1.buf(), token2.buf(), token1.length()) == 0);
     CHECK(token1.cid() == token2.cid());
   }
+
+  SECTION("QUICConnectionId owner tag")
+  {
+    QUICConnectionId cid;
+    cid.randomize();
+    QUICConnectionId before = cid;
+
+    cid.set_owner_tag(7);
+    CHECK(cid.owner_tag() == 7);
+    CHECK(cid.length() == before.length());
+
+    // Only the first byte is taken
+    before.set_owner_tag(7);
+    CHECK(cid == before);
+  }
 }
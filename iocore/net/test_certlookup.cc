@@ -97,6 +97,12 @@ REGRESSION_TEST(SSLCertificateLookup)(RegressionTest *t, int /* atype ATS_UNUSED
   box.check(lookup.find("Mixed.CASE.Com")->getCtx().get() == foo, "mixed case lookup 1 for Mixed.Case.Com");
   box.check(lookup.find("Mixed.Case.Com")->getCtx().get() == foo, "mixed case lookup 2 for Mixed.Case.Com");
   box.check(lookup.find("mixed.case.com")->getCtx().get() == foo, "lower case lookup for Mixed.Case.Com");
+
+  // A host and a wildcard for the same domain.
+  box.check(lookup.insert("wild.com", foo_cc) >= 0, "insert host next to wildcard *.wild.com");
+  box.check(lookup.find("wild.com")->getCtx().get() == foo, "host lookup for wild.com");
+  box.check(lookup.find("x.wild.com")->getCtx().get() == wild, "wildcard lookup for x.wild.com");
+  box.check(lookup.find("a.b.wild.com") == nullptr, "a.b.wild.com won't match *.wild.com because we only match one level");
 }
 
 REGRESSION_TEST(SSLAddressLookup)(RegressionTest *t, int /* atype ATS_UNUSED */, int *pstatus)
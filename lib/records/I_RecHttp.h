@@ -242,6 +242,9 @@ public:
   };
 
   int m_fd;                                 ///< Pre-opened file descriptor if present.
+  /// More pre-opened sockets for the same port, one per net thread beyond the first, when
+  /// proxy.config.exec_thread.listen is set. They are passed as further @c fd options.
+  std::vector<int> m_thread_fds;
   TransportType m_type = TRANSPORT_DEFAULT; ///< Type of connection.
   in_port_t m_port     = 0;                 ///< Port on which to listen.
   uint8_t m_family     = AF_INET;           ///< IP address family.
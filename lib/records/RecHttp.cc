@@ -367,9 +367,11 @@ HttpProxyPort::processOptions(const char *opts)
       int fd = strtoul(value, &ptr, 10);
       if (ptr == value) {
         Warning("Mangled file descriptor value '%s' in port descriptor '%s'", item, opts);
-      } else {
+      } else if (ts::NO_FD == m_fd) {
         m_fd = fd;
         zret = true;
+      } else {
+        m_thread_fds.push_back(fd);
       }
     } else if (nullptr != (value = this->checkPrefix(item, OPT_INBOUND_IP_PREFIX, OPT_INBOUND_IP_PREFIX_LEN))) {
       if (0 == ip.load(value)) {
@@ -579,6 +581,12 @@ HttpProxyPort::print(char *out, size_t n)
       out[zret++] = ':';
     }
     zret += snprintf(out + zret, n - zret, "fd=%d", m_fd);
+    for (int fd : m_thread_fds) {
+      if (zret >= n) {
+        return n;
+      }
+      zret += snprintf(out + zret, n - zret, ":fd=%d", fd);
+    }
   }
   if (zret >= n) {
     return n;
@@ -96,4 +96,23 @@ TEST_CASE("RecHttp", "[librecords][RecHttp]")
     REQUIRE(view.find(":ssl") != TextView::npos);
     REQUIRE(view.find(":proto") == TextView::npos); // it's default, should not have this.
   }
+
+  SECTION("thread-fds")
+  {
+    HttpProxyPort::loadValue(ports, "8080:fd=11:fd=12:fd=13");
+    REQUIRE(ports.size() == 1);
+    REQUIRE(ports[0].m_fd == 11);
+    REQUIRE(ports[0].m_thread_fds == std::vector<int>{12, 13});
+
+    char buff[256];
+    ports[0].print(buff, sizeof(buff));
+    std::string_view view{buff};
+    REQUIRE(view.find("fd=11:fd=12:fd=13") != TextView::npos);
+
+    std::vector<HttpProxyPort> again;
+    HttpProxyPort::loadValue(again, buff);
+    REQUIRE(again.size() == 1);
+    REQUIRE(again[0].m_fd == 11);
+    REQUIRE(again[0].m_thread_fds == ports[0].m_thread_fds);
+  }
 }
@@ -871,7 +871,7 @@ LocalManager::startProxy(const char *onetime_options)
 
     // Pass down port/fd information to traffic_server if there are any open ports.
     if (std::any_of(m_proxy_ports.begin(), m_proxy_ports.end(), [](HttpProxyPort &p) { return ts::NO_FD != p.m_fd; })) {
-      char portbuf[128];
+      char portbuf[OPTIONS_SIZE];
       bool need_comma_p = false;
 
       w.write("--httpport "sv);
@@ -923,8 +923,38 @@ LocalManager::closeProxyPorts()
       close_socket(p.m_fd);
       p.m_fd = ts::NO_FD;
     }
+    for (int fd : p.m_thread_fds) {
+      close_socket(fd);
+    }
+    p.m_thread_fds.clear();
   }
 }
+/*
+ * proxy_listen_sockets()
+ *  The number of sockets to bind per proxy port. With proxy.config.exec_thread.listen that is one per
+ *  traffic_server net thread, counted the way traffic_server does in adjust_num_of_net_threads().
+ */
+static int
+proxy_listen_sockets()
+{
+  bool found;
+  RecInt listen_per_thread = REC_readInteger("proxy.config.exec_thread.listen", &found);
+  if (!found || !listen_per_thread) {
+    return 1;
+  }
+
+  int nthreads    = 1;
+  RecInt autoconf = REC_readInteger("proxy.config.exec_thread.autoconfig", &found);
+  if (found && autoconf) {
+    RecFloat scale = REC_readFloat(const_cast<char *>("proxy.config.exec_thread.autoconfig.scale"), &found);
+    nthreads       = static_cast<int>(ink_number_of_processors() * (found ? scale : 1.0));
+  } else {
+    RecInt limit = REC_readInteger("proxy.config.exec_thread.limit", &found);
+    nthreads     = found ? static_cast<int>(limit) : 1;
+  }
+  return std::clamp(nthreads, 1, TS_MAX_NUMBER_EVENT_THREADS);
+}
+
 /*
  * listenForProxy()
  *  Function listens on the accept port of the proxy, so users aren't dropped.
@@ -936,10 +966,20 @@ LocalManager::listenForProxy()
     return;
   }
 
+  int sockets = proxy_listen_sockets();
+
   // We are not already bound, bind the port
   for (auto &p : lmgmt->m_proxy_ports) {
     if (ts::NO_FD == p.m_fd) {
       this->bindProxyPort(p);
+      // traffic_server runs as another user and can't add its own sockets to the SO_REUSEPORT
+      // group of a port bound here, so the sockets for its other net threads are bound here too.
+      for (int i = 1; i < sockets; ++i) {
+        int fd = p.m_fd;
+        this->bindProxyPort(p);
+        p.m_thread_fds.push_back(p.m_fd);
+        p.m_fd = fd;
+      }
     }
 
     // read backlog configuration value and overwrite the default value if found
@@ -951,6 +991,11 @@ LocalManager::listenForProxy()
     if ((listen(p.m_fd, backlog)) < 0) {
       mgmt_fatal(errno, "[LocalManager::listenForProxy] Unable to listen on port: %d (%.*s)\n", p.m_port, fam.size(), fam.data());
     }
+    for (int fd : p.m_thread_fds) {
+      if ((listen(fd, backlog)) < 0) {
+        mgmt_fatal(errno, "[LocalManager::listenForProxy] Unable to listen on port: %d (%.*s)\n", p.m_port, fam.size(), fam.data());
+      }
+    }
     mgmt_log("[LocalManager::listenForProxy] Listening on port: %d (%.*s)\n", p.m_port, fam.size(), fam.data());
   }
   return;
@@ -1010,6 +1055,17 @@ LocalManager::bindProxyPort(HttpProxyPort &port)
     mgmt_fatal(0, "[bindProxyPort] Unable to set socket options: %d : %s\n", port.m_port, strerror(errno));
   }
 
+#ifdef SO_REUSEPORT
+  {
+    // Every net thread of traffic_server accepts on its own socket for this port, see listenForProxy().
+    bool found;
+    RecInt listen_per_thread = REC_readInteger("proxy.config.exec_thread.listen", &found);
+    if (found && listen_per_thread && setsockopt(port.m_fd, SOL_SOCKET, SO_REUSEPORT, (char *)&one, sizeof(int)) < 0) {
+      mgmt_log("[bindProxyPort] Unable to set SO_REUSEPORT: %d : %s\n", port.m_port, strerror(errno));
+    }
+  }
+#endif
+
   if (port.m_proxy_protocol) {
     Debug("lm", "[bindProxyPort] Proxy Protocol enabled");
   }
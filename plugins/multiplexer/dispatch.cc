@@ -77,22 +77,8 @@ copy(const TSIOBufferReader &r, const TSIOBuffer b)
 {
   assert(r != nullptr);
   assert(b != nullptr);
-  TSIOBufferBlock block = TSIOBufferReaderStart(r);
-
-  uint64_t length = 0;
-
-  for (; block; block = TSIOBufferBlockNext(block)) {
-    int64_t size              = 0;
-    const void *const pointer = TSIOBufferBlockReadStart(block, r, &size);
-
-    if (pointer != nullptr && size > 0) {
-      const int64_t size2 = TSIOBufferWrite(b, pointer, size);
-      assert(size == size2);
-      length += size;
-    }
-  }
-
-  return length;
+  // Every request shares the same body blocks, nothing is copied.
+  return TSIOBufferCopy(b, r, TSIOBufferReaderAvail(r), 0);
 }
 
 uint64_t
@@ -38,10 +38,15 @@
 #include "I_EventSystem.h"
 
 static constexpr size_t MAX_LOST_STR_SPACE        = 1024;
+static constexpr int MIN_MARSHAL_STR_SAVINGS      = 256; ///< Dead string bytes worth dropping when marshalling.
 static constexpr uint32_t MAX_HDR_HEAP_OBJ_LENGTH = (1 << 20) - 1; ///< m_length is 20 bit
 
 Allocator hdrHeapAllocator("hdrHeap", HdrHeap::DEFAULT_SIZE);
+Allocator hdrHeapLargeAllocator("hdrHeapLarge", HdrHeap::LARGE_SIZE);
 Allocator strHeapAllocator("hdrStrHeap", HdrStrHeap::DEFAULT_SIZE);
+Allocator strHeapLargeAllocator("hdrStrHeapLarge", HdrStrHeap::LARGE_SIZE);
+
+HdrHeapStats hdr_heap_stats;
 
 /*-------------------------------------------------------------------------
   -------------------------------------------------------------------------*/
@@ -117,6 +122,8 @@ new_HdrHeap(int size)
   if (size <= HdrHeap::DEFAULT_SIZE) {
     size = HdrHeap::DEFAULT_SIZE;
     h    = (HdrHeap *)(THREAD_ALLOC(hdrHeapAllocator, this_ethread()));
+  } else if (size == HdrHeap::LARGE_SIZE) {
+    h = (HdrHeap *)(THREAD_ALLOC(hdrHeapLargeAllocator, this_ethread()));
   } else {
     h = (HdrHeap *)ats_malloc(size);
   }
@@ -143,7 +150,11 @@ new_HdrStrHeap(int requested_size)
     sh         = (HdrStrHeap *)(THREAD_ALLOC(strHeapAllocator, this_ethread()));
   } else {
     alloc_size = ts::round_up<HdrStrHeap::DEFAULT_SIZE * 2>(alloc_size);
-    sh         = static_cast<HdrStrHeap *>(ats_malloc(alloc_size));
+    if (alloc_size == HdrStrHeap::LARGE_SIZE) {
+      sh = (HdrStrHeap *)(THREAD_ALLOC(strHeapLargeAllocator, this_ethread()));
+    } else {
+      sh = static_cast<HdrStrHeap *>(ats_malloc(alloc_size));
+    }
   }
 
   //    Debug("hdrs", "Allocated string heap in size %d", alloc_size);
@@ -176,6 +187,8 @@ HdrHeap::destroy()
 
   if (m_size == HdrHeap::DEFAULT_SIZE) {
     THREAD_FREE(this, hdrHeapAllocator, this_thread());
+  } else if (m_size == HdrHeap::LARGE_SIZE) {
+    THREAD_FREE(this, hdrHeapLargeAllocator, this_thread());
   } else {
     ats_free(this);
   }
@@ -333,6 +346,7 @@ HdrHeap::demote_rw_str_heap()
 
       //          Debug("hdrs", "Demoted rw heap of %d size", m_read_write_heap->m_heap_size);
       m_read_write_heap = nullptr;
+      hdr_heap_stats.str_demote.fetch_add(1, std::memory_order_relaxed);
       return 0;
     }
   }
@@ -358,12 +372,16 @@ HdrHeap::coalesce_str_heaps(int incoming_size)
   ink_assert(incoming_size >= 0);
   ink_assert(m_writeable);
 
-  new_heap_size += required_space_for_evacuation();
+  size_t evacuate_size = required_space_for_evacuation();
+  new_heap_size += evacuate_size;
 
   HdrStrHeap *new_heap = new_HdrStrHeap(new_heap_size);
   evacuate_from_str_heaps(new_heap);
   m_lost_string_space = 0;
 
+  hdr_heap_stats.str_coalesce.fetch_add(1, std::memory_order_relaxed);
+  hdr_heap_stats.str_coalesce_bytes.fetch_add(evacuate_size, std::memory_order_relaxed);
+
   // At this point none of the currently used string
   //  heaps are needed since everything is in the
   //  new string heap.  So deallocate all the old heaps
@@ -385,6 +403,70 @@ HdrHeap::coalesce_str_heaps(int incoming_size)
   ink_assert(heaps_removed > 0 || incoming_size > 0 || m_ronly_heap[0].m_heap_start == nullptr);
 }
 
+// Move the strings of the objects in [data, end) to new_heap
+static void
+move_obj_strings(char *data, char *end, HdrStrHeap *new_heap)
+{
+  while (data < end) {
+    HdrHeapObjImpl *obj = (HdrHeapObjImpl *)data;
+
+    switch (obj->m_type) {
+    case HDR_HEAP_OBJ_URL:
+      ((URLImpl *)obj)->move_strings(new_heap);
+      break;
+    case HDR_HEAP_OBJ_HTTP_HEADER:
+      ((HTTPHdrImpl *)obj)->move_strings(new_heap);
+      break;
+    case HDR_HEAP_OBJ_MIME_HEADER:
+      ((MIMEHdrImpl *)obj)->move_strings(new_heap);
+      break;
+    case HDR_HEAP_OBJ_FIELD_BLOCK:
+      ((MIMEFieldBlockImpl *)obj)->move_strings(new_heap);
+      break;
+    case HDR_HEAP_OBJ_EMPTY:
+    case HDR_HEAP_OBJ_RAW:
+      // Nothing to do
+      break;
+    default:
+      ink_release_assert(0);
+    }
+
+    data = data + obj->m_length;
+  }
+}
+
+// Total length of the strings of the objects in [data, end)
+static size_t
+obj_strings_length(char *data, char *end)
+{
+  size_t ret = 0;
+
+  while (data < end) {
+    HdrHeapObjImpl *obj = (HdrHeapObjImpl *)data;
+
+    switch (obj->m_type) {
+    case HDR_HEAP_OBJ_URL:
+      ret += ((URLImpl *)obj)->strings_length();
+      break;
+    case HDR_HEAP_OBJ_HTTP_HEADER:
+      ret += ((HTTPHdrImpl *)obj)->strings_length();
+      break;
+    case HDR_HEAP_OBJ_MIME_HEADER:
+      ret += ((MIMEHdrImpl *)obj)->strings_length();
+      break;
+    case HDR_HEAP_OBJ_FIELD_BLOCK:
+      ret += ((MIMEFieldBlockImpl *)obj)->strings_length();
+      break;
+    default:
+      // Nothing to do
+      break;
+    }
+
+    data = data + obj->m_length;
+  }
+  return ret;
+}
+
 void
 HdrHeap::evacuate_from_str_heaps(HdrStrHeap *new_heap)
 {
@@ -395,35 +477,7 @@ HdrHeap::evacuate_from_str_heaps(HdrStrHeap *new_heap)
   ink_assert(m_writeable);
 
   while (h) {
-    char *data = h->m_data_start;
-
-    while (data < h->m_free_start) {
-      HdrHeapObjImpl *obj = (HdrHeapObjImpl *)data;
-
-      switch (obj->m_type) {
-      case HDR_HEAP_OBJ_URL:
-        ((URLImpl *)obj)->move_strings(new_heap);
-        break;
-      case HDR_HEAP_OBJ_HTTP_HEADER:
-        ((HTTPHdrImpl *)obj)->move_strings(new_heap);
-        break;
-      case HDR_HEAP_OBJ_MIME_HEADER:
-        ((MIMEHdrImpl *)obj)->move_strings(new_heap);
-        break;
-      case HDR_HEAP_OBJ_FIELD_BLOCK:
-        ((MIMEFieldBlockImpl *)obj)->move_strings(new_heap);
-        break;
-      case HDR_HEAP_OBJ_EMPTY:
-      case HDR_HEAP_OBJ_RAW:
-        // Nothing to do
-        break;
-      default:
-        ink_release_assert(0);
-      }
-
-      data = data + obj->m_length;
-    }
-
+    move_obj_strings(h->m_data_start, h->m_free_start, new_heap);
     h = h->m_next;
   }
 }
@@ -563,6 +617,31 @@ HdrHeap::marshal_length()
     h = h->m_next;
   }
 
+  int dropped;
+  len += marshal_str_length(dropped);
+
+  len = HdrHeapMarshalBlocks(ts::round_up(len));
+  return len;
+}
+
+// int HdrHeap::marshal_str_length(int& dropped)
+//
+//  Determines how many string bytes a marshalled copy of
+//   this header carries.  Normally the string heaps are
+//   copied whole, dead strings and all, because that is
+//   just a few memcpy's.  But a header parsed in place
+//   references whole IOBuffer blocks and one that has been
+//   edited a lot has plenty of lost space, and those bytes
+//   would be written to the cache and read back on every
+//   hit.  If most of the string space is dead, only the
+//   live strings are counted and @a dropped is set to the
+//   number of bytes left out, otherwise it is zero
+//
+int
+HdrHeap::marshal_str_length(int &dropped)
+{
+  int len = 0;
+
   // Since when we unmarshal, we won't have a writable string
   //  heap, we can drop the header on the read/write
   //  string heap
@@ -576,7 +655,20 @@ HdrHeap::marshal_length()
     }
   }
 
-  len = HdrHeapMarshalBlocks(ts::round_up(len));
+  dropped = 0;
+  if (len >= MIN_MARSHAL_STR_SAVINGS) {
+    // Don't use required_space_for_evacuation(), it tidies up the
+    //   heap and we might be a read only header out of the cache
+    int live = 0;
+    for (HdrHeap *h = this; h; h = h->m_next) {
+      live += static_cast<int>(obj_strings_length(h->m_data_start, h->m_free_start));
+    }
+    if (len - live >= MIN_MARSHAL_STR_SAVINGS && len - live > live) {
+      dropped = len - live;
+      len     = live;
+    }
+  }
+
   return len;
 }
 
@@ -638,6 +730,8 @@ HdrHeap::marshal(char *buf, int len)
   // Variables used later on.  Sunpro doesn't like
   //   bypassing initializations with gotos
   int used;
+  int live_size;
+  int dropped;
 
   HdrHeap *unmarshal_hdr = this;
 
@@ -695,51 +789,81 @@ HdrHeap::marshal(char *buf, int len)
   //   translation table for string marshaling in the heap
   //   objects
   //
-  // FIX ME - really ought to check to see if lost_string_space
-  //   is too big and only copy over live strings if it is.  May
-  //   not be too much of a problem since I've prevented too much
-  //   lost string space both in string alloc and inherit
+  // If most of the string space is dead we only copy over the
+  //   live strings, see marshal_str_length()
+  live_size = marshal_str_length(dropped);
 
-  if (m_read_write_heap) {
-    char *copy_start = ((char *)m_read_write_heap.get()) + sizeof(HdrStrHeap);
-    int nto_copy     = m_read_write_heap->m_heap_size - (sizeof(HdrStrHeap) + m_read_write_heap->m_free_size);
-
-    if (nto_copy > len) {
+  if (dropped > 0) {
+    if (live_size > len) {
       goto Failed;
     }
 
-    memcpy(b, copy_start, nto_copy);
+    // Evacuate the strings of the objects we just copied straight
+    //   into the marshal buffer.  The string heap is only used to
+    //   hand out the space so it can live on the stack
+    {
+      HdrStrHeap live_heap;
+      live_heap.m_heap_size  = 0;
+      live_heap.m_free_start = b;
+      live_heap.m_free_size  = live_size;
+      move_obj_strings(buf + HDR_HEAP_HDR_SIZE, buf + marshal_hdr->m_size, &live_heap);
+      ink_assert(live_heap.m_free_size == 0);
+    }
 
-    // FIX ME - possible offset overflow issues?
-    str_xlation[str_heaps].start  = copy_start;
-    str_xlation[str_heaps].end    = copy_start + nto_copy;
-    str_xlation[str_heaps].offset = copy_start - (b - buf);
+    str_xlation[str_heaps].start  = b;
+    str_xlation[str_heaps].end    = b + live_size;
+    str_xlation[str_heaps].offset = buf;
 
-    b += nto_copy;
-    len -= nto_copy;
-    str_size += nto_copy;
+    b += live_size;
+    len -= live_size;
+    str_size += live_size;
     str_heaps++;
-  }
 
-  for (auto &i : m_ronly_heap) {
-    if (i.m_heap_start != nullptr) {
-      if (i.m_heap_len > len) {
+    marshal_hdr->m_lost_string_space = 0;
+    hdr_heap_stats.marshal_compact.fetch_add(1, std::memory_order_relaxed);
+    hdr_heap_stats.marshal_compact_bytes.fetch_add(dropped, std::memory_order_relaxed);
+  } else {
+    if (m_read_write_heap) {
+      char *copy_start = ((char *)m_read_write_heap.get()) + sizeof(HdrStrHeap);
+      int nto_copy     = m_read_write_heap->m_heap_size - (sizeof(HdrStrHeap) + m_read_write_heap->m_free_size);
+
+      if (nto_copy > len) {
         goto Failed;
       }
 
-      memcpy(b, i.m_heap_start, i.m_heap_len);
+      memcpy(b, copy_start, nto_copy);
 
-      // Add translation table entry for string heaps
-      //   FIX ME - possible offset overflow issues?
-      str_xlation[str_heaps].start  = i.m_heap_start;
-      str_xlation[str_heaps].end    = i.m_heap_start + i.m_heap_len;
-      str_xlation[str_heaps].offset = str_xlation[str_heaps].start - (b - buf);
-      ink_assert(str_xlation[str_heaps].start <= str_xlation[str_heaps].end);
+      // FIX ME - possible offset overflow issues?
+      str_xlation[str_heaps].start  = copy_start;
+      str_xlation[str_heaps].end    = copy_start + nto_copy;
+      str_xlation[str_heaps].offset = copy_start - (b - buf);
 
+      b += nto_copy;
+      len -= nto_copy;
+      str_size += nto_copy;
       str_heaps++;
-      b += i.m_heap_len;
-      len -= i.m_heap_len;
-      str_size += i.m_heap_len;
+    }
+
+    for (auto &i : m_ronly_heap) {
+      if (i.m_heap_start != nullptr) {
+        if (i.m_heap_len > len) {
+          goto Failed;
+        }
+
+        memcpy(b, i.m_heap_start, i.m_heap_len);
+
+        // Add translation table entry for string heaps
+        //   FIX ME - possible offset overflow issues?
+        str_xlation[str_heaps].start  = i.m_heap_start;
+        str_xlation[str_heaps].end    = i.m_heap_start + i.m_heap_len;
+        str_xlation[str_heaps].offset = str_xlation[str_heaps].start - (b - buf);
+        ink_assert(str_xlation[str_heaps].start <= str_xlation[str_heaps].end);
+
+        str_heaps++;
+        b += i.m_heap_len;
+        len -= i.m_heap_len;
+        str_size += i.m_heap_len;
+      }
     }
   }
 
@@ -973,27 +1097,39 @@ HdrHeap::unmarshal(int buf_length, int obj_type, HdrHeapObjImpl **found_obj, Ref
   return unmarshal_size;
 }
 
+StrHeapDesc *
+HdrHeap::find_ronly_str_heap(const RefCountObj *h_ref_obj)
+{
+  for (auto &i : m_ronly_heap) {
+    if (i.m_heap_start != nullptr && i.m_ref_count_ptr.get() == h_ref_obj) {
+      return &i;
+    }
+  }
+  return nullptr;
+}
+
 inline bool
 HdrHeap::attach_str_heap(char const *h_start, int h_len, RefCountObj *h_ref_obj, int *index)
 {
-  if (*index >= static_cast<int>(HDR_BUF_RONLY_HEAPS)) {
-    return false;
+  // Our own read-write heap already covers anything that was copied from it
+  if (h_ref_obj == m_read_write_heap.get()) {
+    return true;
   }
 
-  // Loop over existing entries to see if this one is already present
-  for (int z = 0; z < *index; z++) {
-    if (m_ronly_heap[z].m_heap_start == h_start) {
-      ink_assert(m_ronly_heap[z].m_ref_count_ptr.object() == h_ref_obj);
-
-      // The lengths could be different because our copy could be
-      //   read-only and the copy we are attaching from could be
-      //   read-write and have expanded since the last time
-      //   to was attached
-      if (h_len > m_ronly_heap[z].m_heap_len) {
-        m_ronly_heap[z].m_heap_len = h_len;
-      }
-      return true;
-    }
+  // See if this one is already present. The ranges could be different
+  //   because our copy could be read-only and the copy we are attaching
+  //   from could be read-write and have expanded since the last time
+  //   it was attached, or because both are parts of the same IOBufferBlock
+  if (StrHeapDesc *desc = find_ronly_str_heap(h_ref_obj); desc != nullptr) {
+    const char *start  = std::min(desc->m_heap_start, h_start);
+    const char *end    = std::max(desc->m_heap_start + desc->m_heap_len, h_start + h_len);
+    desc->m_heap_start = start;
+    desc->m_heap_len   = end - start;
+    return true;
+  }
+
+  if (*index >= static_cast<int>(HDR_BUF_RONLY_HEAPS)) {
+    return false;
   }
 
   m_ronly_heap[*index].m_ref_count_ptr = h_ref_obj;
@@ -1033,14 +1169,29 @@ HdrHeap::inherit_string_heaps(const HdrHeap *inherit_from)
     }
   }
 
-  // Find out if we have enough slots
+  // Find out if we have enough slots. Heaps we already share with
+  //  inherit_from, e.g. when a header is copied onto one that was
+  //  copied from it before, don't need another one.
+  int shared_heaps = 0;
+  auto is_shared   = [this](const RefCountObj *ref) {
+    return ref == m_read_write_heap.get() || find_ronly_str_heap(ref) != nullptr;
+  };
+
   if (inherit_from->m_read_write_heap) {
-    free_slots--;
+    if (is_shared(inherit_from->m_read_write_heap.get())) {
+      shared_heaps++;
+    } else {
+      free_slots--;
+    }
     inherit_str_size = inherit_from->m_read_write_heap->m_heap_size;
   }
   for (const auto &index : inherit_from->m_ronly_heap) {
     if (index.m_heap_start != nullptr) {
-      free_slots--;
+      if (is_shared(index.m_ref_count_ptr.get())) {
+        shared_heaps++;
+      } else {
+        free_slots--;
+      }
       inherit_str_size += index.m_heap_len;
     } else {
       // Heaps are allocated from the front of the array, so if
@@ -1078,6 +1229,7 @@ HdrHeap::inherit_string_heaps(const HdrHeap *inherit_from)
     }
 
     m_lost_string_space += inherit_from->m_lost_string_space;
+    hdr_heap_stats.str_inherit_shared.fetch_add(shared_heaps, std::memory_order_relaxed);
   }
 
   return;
@@ -1129,6 +1281,8 @@ HdrStrHeap::free()
 {
   if (m_heap_size == HdrStrHeap::DEFAULT_SIZE) {
     THREAD_FREE(this, strHeapAllocator, this_thread());
+  } else if (m_heap_size == HdrStrHeap::LARGE_SIZE) {
+    THREAD_FREE(this, strHeapLargeAllocator, this_thread());
   } else {
     ats_free(this);
   }
@@ -39,6 +39,8 @@
 #include "tscore/Scalar.h"
 #include "HdrToken.h"
 
+#include <atomic>
+
 // Objects in the heap must currently be aligned to 8 byte boundaries,
 // so their (address & HDR_PTR_ALIGNMENT_MASK) == 0
 
@@ -134,6 +136,8 @@ class HdrStrHeap : public RefCountObj
 {
 public:
   static constexpr int DEFAULT_SIZE = 2048;
+  /// String heaps of this size also come from a thread freelist, they are the first size up from @c DEFAULT_SIZE.
+  static constexpr int LARGE_SIZE = DEFAULT_SIZE * 2;
 
   void free() override;
 
@@ -169,12 +173,26 @@ struct StrHeapDesc {
   }
 };
 
+/// Process wide counts of string heap maintenance, published as @c proxy.process.http.hdr_heap.* stats.
+struct HdrHeapStats {
+  std::atomic<uint64_t> str_coalesce{0};          ///< String heaps coalesced into one.
+  std::atomic<uint64_t> str_coalesce_bytes{0};    ///< Bytes copied by coalescing.
+  std::atomic<uint64_t> str_demote{0};            ///< Read-write string heaps demoted to read only.
+  std::atomic<uint64_t> str_inherit_shared{0};    ///< Inherited string heaps that were already attached.
+  std::atomic<uint64_t> marshal_compact{0};       ///< Heaps marshalled with only their live strings.
+  std::atomic<uint64_t> marshal_compact_bytes{0}; ///< Dead string bytes left out of marshalled heaps.
+};
+
+extern HdrHeapStats hdr_heap_stats;
+
 class HdrHeap
 {
   friend class CoreUtils;
 
 public:
   static constexpr int DEFAULT_SIZE = 2048;
+  /// Heaps of this size also come from a thread freelist, it is the size of the first overflow heap.
+  static constexpr int LARGE_SIZE = DEFAULT_SIZE * 2;
 
   void init();
   inkcoreapi void destroy();
@@ -285,7 +303,9 @@ public:
   void coalesce_str_heaps(int incoming_size = 0);
   void evacuate_from_str_heaps(HdrStrHeap *new_heap);
   size_t required_space_for_evacuation();
+  int marshal_str_length(int &dropped);
   bool attach_str_heap(char const *h_start, int h_len, RefCountObj *h_ref_obj, int *index);
+  StrHeapDesc *find_ronly_str_heap(const RefCountObj *h_ref_obj);
 
   /** Struct to prevent garbage collection on heaps.
       This bumps the reference count to the heap containing the pointer
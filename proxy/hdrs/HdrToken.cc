@@ -22,32 +22,20 @@
  */
 
 #include "tscore/ink_platform.h"
-#include "tscore/HashFNV.h"
 #include "tscore/Diags.h"
 #include "tscore/ink_memory.h"
 #include <cstdio>
+#include <string_view>
 #include "tscore/Allocator.h"
 #include "HTTP.h"
 #include "HdrToken.h"
 #include "MIME.h"
-#include "tscore/Regex.h"
 #include "URL.h"
 
-/*
- You SHOULD add to _hdrtoken_commonly_tokenized_strs, with the same ordering
- ** important, ordering matters **
-
- You want a regexp like 'Accept' after "greedier" choices so it doesn't match 'Accept-Ranges' earlier than
- it should. The regexp are anchored (^Accept), but I dont see a way with the current system to
- match the word ONLY without making _hdrtoken_strs a real PCRE, but then that breaks the hashing
- hdrtoken_hash("^Accept$") != hdrtoken_hash("Accept")
-
- So, the current hack is to have "Accept" follow "Accept-.*", lame, I know
-
-  /ericb
-*/
-
-static const char *_hdrtoken_strs[] = {
+// WARNING:  Indexes into this array are stored on disk for cached objects.  New strings must be added at the end of the array to
+// avoid changing the indexes of pre-existing entries, unless the cache format version number is increased.
+//
+static constexpr std::string_view _hdrtoken_strs[] = {
   // MIME Field names
   "Accept-Charset", "Accept-Encoding", "Accept-Language", "Accept-Ranges", "Accept", "Age", "Allow",
   "Approved", // NNTP
@@ -253,148 +241,124 @@ int32_t hdrtoken_str_slotids[SIZEOF(_hdrtoken_strs)];          // wks_idx -> slo
 uint64_t hdrtoken_str_masks[SIZEOF(_hdrtoken_strs)];           // wks_idx -> presence mask
 uint32_t hdrtoken_str_flags[SIZEOF(_hdrtoken_strs)];           // wks_idx -> flags
 
-DFA *hdrtoken_strs_dfa = nullptr;
-
 /***********************************************************************
  *                                                                     *
  *                        H A S H    T A B L E                         *
  *                                                                     *
  ***********************************************************************/
 
-#define HDRTOKEN_HASH_TABLE_SIZE 65536
+// Well-known strings are found with a perfect hash built at compile time (hash and displace). A string
+// hashes to a bucket, the displacement of the bucket picks its slot, and the slot holds the only
+// well-known string the input can be, so one case-insensitive compare decides the lookup.
 
-struct HdrTokenHashBucket {
-  const char *wks;
-  uint32_t hash;
-};
+static constexpr int HDRTOKEN_HASH_BUCKETS = 64;
+static constexpr int HDRTOKEN_HASH_SLOTS   = 256;
 
-HdrTokenHashBucket hdrtoken_hash_table[HDRTOKEN_HASH_TABLE_SIZE];
+static_assert(SIZEOF(_hdrtoken_strs) <= HDRTOKEN_HASH_SLOTS, "too many well-known strings for the perfect hash");
 
 /**
-  basic FNV hash
+  basic FNV hash, case-insensitive for letters
 **/
-#define TINY_MASK(x) (((uint32_t)1 << (x)) - 1)
-
-inline uint32_t
-hash_to_slot(uint32_t hash)
+static constexpr uint32_t
+hdrtoken_hash(const char *string, int length)
 {
-  return ((hash >> 15) ^ hash) & TINY_MASK(15);
+  uint32_t hash = 2166136261u;
+  for (int i = 0; i < length; ++i) {
+    hash ^= static_cast<unsigned char>(string[i]) | 0x20;
+    hash *= 16777619u;
+  }
+  return hash;
 }
 
-inline uint32_t
-hdrtoken_hash(const unsigned char *string, unsigned int length)
+static constexpr uint32_t
+hdrtoken_hash_slot(uint32_t hash, uint32_t displacement)
 {
-  ATSHash32FNV1a fnv;
-  fnv.update(string, length, ATSHash::nocase());
-  fnv.final();
-  return fnv.get();
+  uint32_t x = hash ^ (displacement * 0x9E3779B9u);
+  x ^= x >> 16;
+  x *= 0x85EBCA6Bu;
+  x ^= x >> 13;
+  return x & (HDRTOKEN_HASH_SLOTS - 1);
 }
 
-/*-------------------------------------------------------------------------
-  -------------------------------------------------------------------------*/
-
-// WARNING:  Indexes into this array are stored on disk for cached objects.  New strings must be added at the end of the array to
-// avoid changing the indexes of pre-existing entries, unless the cache format version number is increased.
-//
-static const char *_hdrtoken_commonly_tokenized_strs[] = {
-  // MIME Field names
-  "Accept-Charset", "Accept-Encoding", "Accept-Language", "Accept-Ranges", "Accept", "Age", "Allow",
-  "Approved", // NNTP
-  "Authorization",
-  "Bytes", // NNTP
-  "Cache-Control", "Client-ip", "Connection", "Content-Base", "Content-Encoding", "Content-Language", "Content-Length",
-  "Content-Location", "Content-MD5", "Content-Range", "Content-Type",
-  "Control", // NNTP
-  "Cookie", "Date",
-  "Distribution", // NNTP
-  "Etag", "Expect", "Expires",
-  "Followup-To", // NNTP
-  "From", "Host", "If-Match", "If-Modified-Since", "If-None-Match", "If-Range", "If-Unmodified-Since", "Keep-Alive",
-  "Keywords", // NNTP
-  "Last-Modified",
-  "Lines", // NNTP
-  "Location", "Max-Forwards",
-  "Message-ID", // NNTP
-  "MIME-Version",
-  "Newsgroups",   // NNTP
-  "Organization", // NNTP
-  "Path",         // NNTP
-  "Pragma", "Proxy-Authenticate", "Proxy-Authorization", "Proxy-Connection", "Public", "Range",
-  "References", // NNTP
-  "Referer",
-  "Reply-To", // NNTP
-  "Retry-After",
-  "Sender", // NNTP
-  "Server", "Set-Cookie",
-  "Subject", // NNTP
-  "Summary", // NNTP
-  "Transfer-Encoding", "Upgrade", "User-Agent", "Vary", "Via", "Warning", "Www-Authenticate",
-  "Xref",          // NNTP
-  "@Ats-Internal", // Internal Hack
-
-  // Accept-Encoding
-  "compress", "deflate", "gzip", "identity",
-
-  // Cache-Control flags
-  "max-age", "max-stale", "min-fresh", "must-revalidate", "no-cache", "no-store", "no-transform", "only-if-cached", "private",
-  "proxy-revalidate", "s-maxage", "need-revalidate-once",
-
-  // HTTP miscellaneous
-  "none", "chunked", "close",
-
-  // WS
-  "websocket", "Sec-WebSocket-Key", "Sec-WebSocket-Version",
-
-  // HTTP/2 cleartext
-  MIME_UPGRADE_H2C_TOKEN, "HTTP2-Settings",
-
-  // URL schemes
-  "file", "ftp", "gopher", "https", "http", "mailto", "news", "nntp", "prospero", "telnet", "tunnel", "wais", "pnm", "rtspu",
-  "rtsp", "mmsu", "mmst", "mms", "wss", "ws",
+struct HdrTokenPerfectHash {
+  uint16_t displacement[HDRTOKEN_HASH_BUCKETS] = {};
+  int16_t slot[HDRTOKEN_HASH_SLOTS]            = {}; ///< wks_idx + 1, 0 if the slot is empty.
+  bool valid                                   = false;
+};
 
-  // HTTP methods
-  "CONNECT", "DELETE", "GET", "POST", "HEAD", "OPTIONS", "PURGE", "PUT", "TRACE", "PUSH",
+static constexpr HdrTokenPerfectHash
+hdrtoken_build_perfect_hash()
+{
+  HdrTokenPerfectHash ph;
+  uint32_t hashes[SIZEOF(_hdrtoken_strs)] = {};
+  int bucket_size[HDRTOKEN_HASH_BUCKETS]  = {};
+  int max_bucket_size                     = 0;
+
+  for (unsigned i = 0; i < SIZEOF(_hdrtoken_strs); ++i) {
+    hashes[i] = hdrtoken_hash(_hdrtoken_strs[i].data(), _hdrtoken_strs[i].size());
+    int size  = ++bucket_size[hashes[i] % HDRTOKEN_HASH_BUCKETS];
+    if (size > max_bucket_size) {
+      max_bucket_size = size;
+    }
+  }
 
-  // Header extensions
-  "X-ID", "X-Forwarded-For", "TE", "Strict-Transport-Security", "100-continue",
+  // Place the fullest buckets first, while most slots are free.
+  for (int size = max_bucket_size; size > 0; --size) {
+    for (int b = 0; b < HDRTOKEN_HASH_BUCKETS; ++b) {
+      if (bucket_size[b] != size) {
+        continue;
+      }
+      uint32_t d = 0;
+      for (; d < UINT16_MAX; ++d) {
+        bool placed = true;
+        for (unsigned i = 0; placed && i < SIZEOF(_hdrtoken_strs); ++i) {
+          if (hashes[i] % HDRTOKEN_HASH_BUCKETS == static_cast<uint32_t>(b)) {
+            uint32_t slot = hdrtoken_hash_slot(hashes[i], d);
+            placed        = ph.slot[slot] == 0;
+            // Claim the slot now so the bucket's own strings must not collide either, undone below on failure.
+            if (placed) {
+              ph.slot[slot] = i + 1;
+            }
+          }
+        }
+        if (placed) {
+          break;
+        }
+        for (unsigned i = 0; i < SIZEOF(_hdrtoken_strs); ++i) {
+          uint32_t slot = hdrtoken_hash_slot(hashes[i], d);
+          if (hashes[i] % HDRTOKEN_HASH_BUCKETS == static_cast<uint32_t>(b) && ph.slot[slot] == static_cast<int16_t>(i + 1)) {
+            ph.slot[slot] = 0;
+          }
+        }
+      }
+      if (d == UINT16_MAX) {
+        return ph;
+      }
+      ph.displacement[b] = d;
+    }
+  }
+  ph.valid = true;
+  return ph;
+}
 
-  // RFC-2739
-  "Forwarded"};
+static constexpr HdrTokenPerfectHash hdrtoken_perfect_hash = hdrtoken_build_perfect_hash();
+static_assert(hdrtoken_perfect_hash.valid, "no perfect hash found for the well-known strings, change HDRTOKEN_HASH_SLOTS");
 
-/*-------------------------------------------------------------------------
-  -------------------------------------------------------------------------*/
-
-void
-hdrtoken_hash_init()
+/**
+  @return the index of the well-known string @a string could be, or -1 if there is none.
+**/
+static inline int
+hdrtoken_hash_lookup(const char *string, int length)
 {
-  uint32_t i;
-  int num_collisions;
-
-  memset(hdrtoken_hash_table, 0, sizeof(hdrtoken_hash_table));
-  num_collisions = 0;
-
-  for (i = 0; i < (int)SIZEOF(_hdrtoken_commonly_tokenized_strs); i++) {
-    // convert the common string to the well-known token
-    unsigned const char *wks;
-    int wks_idx = hdrtoken_tokenize_dfa(_hdrtoken_commonly_tokenized_strs[i], (int)strlen(_hdrtoken_commonly_tokenized_strs[i]),
-                                        (const char **)&wks);
-    ink_release_assert(wks_idx >= 0);
-
-    uint32_t hash = hdrtoken_hash(wks, hdrtoken_str_lengths[wks_idx]);
-    uint32_t slot = hash_to_slot(hash);
-
-    if (hdrtoken_hash_table[slot].wks) {
-      printf("ERROR: hdrtoken_hash_table[%u] collision: '%s' replacing '%s'\n", slot, (const char *)wks,
-             hdrtoken_hash_table[slot].wks);
-      ++num_collisions;
-    }
-    hdrtoken_hash_table[slot].wks  = (const char *)wks;
-    hdrtoken_hash_table[slot].hash = hash;
-  }
+  uint32_t hash = hdrtoken_hash(string, length);
+  uint32_t slot = hdrtoken_hash_slot(hash, hdrtoken_perfect_hash.displacement[hash % HDRTOKEN_HASH_BUCKETS]);
+  int wks_idx   = hdrtoken_perfect_hash.slot[slot] - 1;
 
-  if (num_collisions > 0) {
-    abort();
+  if (wks_idx >= 0 && static_cast<int>(_hdrtoken_strs[wks_idx].size()) == length &&
+      strncasecmp(string, _hdrtoken_strs[wks_idx].data(), length) == 0) {
+    return wks_idx;
   }
+  return -1;
 }
 
 /***********************************************************************
@@ -425,9 +389,6 @@ hdrtoken_init()
   if (!inited) {
     inited = 1;
 
-    hdrtoken_strs_dfa = new DFA;
-    hdrtoken_strs_dfa->compile(_hdrtoken_strs, SIZEOF(_hdrtoken_strs), (REFlags)(RE_CASE_INSENSITIVE));
-
     // all the tokenized hdrtoken strings are placed in a special heap,
     // and each string is prepended with a HdrTokenHeapPrefix ---
     // this makes it easy to tell that a string is a tokenized
@@ -437,7 +398,7 @@ hdrtoken_init()
 
     int heap_size = 0;
     for (i = 0; i < (int)SIZEOF(_hdrtoken_strs); i++) {
-      hdrtoken_str_lengths[i]   = (int)strlen(_hdrtoken_strs[i]);
+      hdrtoken_str_lengths[i]   = (int)_hdrtoken_strs[i].size();
       int sstr_len              = snap_up_to_multiple(hdrtoken_str_lengths[i] + 1, sizeof(HdrTokenHeapPrefix));
       int packed_prefix_str_len = sizeof(HdrTokenHeapPrefix) + sstr_len;
       heap_size += packed_prefix_str_len;
@@ -467,7 +428,7 @@ hdrtoken_init()
       heap_ptr += sizeof(HdrTokenHeapPrefix);   // advance heap ptr past index
       hdrtoken_strs[i] = heap_ptr;              // record string pointer
       // coverity[secure_coding]
-      ink_strlcpy((char *)hdrtoken_strs[i], _hdrtoken_strs[i], heap_size - sizeof(HdrTokenHeapPrefix)); // copy string into heap
+      ink_strlcpy((char *)hdrtoken_strs[i], _hdrtoken_strs[i].data(), heap_size - sizeof(HdrTokenHeapPrefix)); // copy string into heap
       heap_ptr += sstr_len; // advance heap ptr past string
       heap_size -= sstr_len;
     }
@@ -477,8 +438,7 @@ hdrtoken_init()
       int wks_idx;
       HdrTokenHeapPrefix *prefix;
 
-      wks_idx =
-        hdrtoken_tokenize_dfa(_hdrtoken_strs_type_initializers[i].name, (int)strlen(_hdrtoken_strs_type_initializers[i].name));
+      wks_idx = hdrtoken_hash_lookup(_hdrtoken_strs_type_initializers[i].name, (int)strlen(_hdrtoken_strs_type_initializers[i].name));
 
       ink_assert((wks_idx >= 0) && (wks_idx < (int)SIZEOF(hdrtoken_strs)));
       // coverity[negative_returns]
@@ -492,7 +452,7 @@ hdrtoken_init()
       HdrTokenHeapPrefix *prefix;
 
       wks_idx =
-        hdrtoken_tokenize_dfa(_hdrtoken_strs_field_initializers[i].name, (int)strlen(_hdrtoken_strs_field_initializers[i].name));
+        hdrtoken_hash_lookup(_hdrtoken_strs_field_initializers[i].name, (int)strlen(_hdrtoken_strs_field_initializers[i].name));
 
       ink_assert((wks_idx >= 0) && (wks_idx < (int)SIZEOF(hdrtoken_strs)));
       prefix                  = hdrtoken_index_to_prefix(wks_idx);
@@ -509,34 +469,7 @@ hdrtoken_init()
       hdrtoken_str_masks[i]       = prefix->wks_info.mask;   // parallel array for speed
       hdrtoken_str_flags[i]       = prefix->wks_info.flags;  // parallel array for speed
     }
-
-    hdrtoken_hash_init();
-  }
-}
-
-/*-------------------------------------------------------------------------
-  -------------------------------------------------------------------------*/
-
-int
-hdrtoken_tokenize_dfa(const char *string, int string_len, const char **wks_string_out)
-{
-  int wks_idx;
-
-  wks_idx = hdrtoken_strs_dfa->match({string, size_t(string_len)});
-
-  if (wks_idx < 0) {
-    wks_idx = -1;
-  }
-  if (wks_string_out) {
-    if (wks_idx >= 0) {
-      *wks_string_out = hdrtoken_index_to_wks(wks_idx);
-    } else {
-      *wks_string_out = nullptr;
-    }
   }
-  // printf("hdrtoken_tokenize_dfa(%d,*s) - return %d\n",string_len,string,wks_idx);
-
-  return wks_idx;
 }
 
 /*-------------------------------------------------------------------------
@@ -546,7 +479,6 @@ int
 hdrtoken_tokenize(const char *string, int string_len, const char **wks_string_out)
 {
   int wks_idx;
-  HdrTokenHashBucket *bucket;
 
   ink_assert(string != nullptr);
 
@@ -558,14 +490,10 @@ hdrtoken_tokenize(const char *string, int string_len, const char **wks_string_ou
     return wks_idx;
   }
 
-  uint32_t hash = hdrtoken_hash((const unsigned char *)string, (unsigned int)string_len);
-  uint32_t slot = hash_to_slot(hash);
-
-  bucket = &(hdrtoken_hash_table[slot]);
-  if ((bucket->wks != nullptr) && (bucket->hash == hash) && (hdrtoken_wks_to_length(bucket->wks) == string_len)) {
-    wks_idx = hdrtoken_wks_to_index(bucket->wks);
+  wks_idx = hdrtoken_hash_lookup(string, string_len);
+  if (wks_idx >= 0) {
     if (wks_string_out) {
-      *wks_string_out = bucket->wks;
+      *wks_string_out = hdrtoken_index_to_wks(wks_idx);
     }
     return wks_idx;
   }
@@ -23,8 +23,8 @@
 
 #include "HuffmanCodec.h"
 #include "tscore/ink_platform.h"
-#include "tscore/ink_memory.h"
 #include "tscore/ink_defs.h"
+#include "tscore/ink_assert.h"
 
 struct huffman_entry {
   uint32_t code_as_hex;
@@ -70,125 +70,121 @@ static const huffman_entry huffman_table[] = {
   {0x7ffffe8, 27}, {0x7ffffe9, 27},  {0x7ffffea, 27}, {0x7ffffeb, 27},  {0xffffffe, 28}, {0x7ffffec, 27}, {0x7ffffed, 27},
   {0x7ffffee, 27}, {0x7ffffef, 27},  {0x7fffff0, 27}, {0x3ffffee, 26},  {0x3fffffff, 30}};
 
-typedef struct node {
-  node *left, *right;
-  char ascii_code;
-  bool leaf_node;
-} Node;
+// The decoder consumes the input a nibble at a time. Its states are the 256 internal nodes of the
+// Huffman tree, and every (state, nibble) pair has a precomputed transition that gives the next
+// state and the symbol completed on the way, if any. No code is shorter than 5 bits, so a nibble
+// completes at most one symbol.
+enum {
+  HUFFMAN_DECODE_SYMBOL = 0x01, ///< The transition completed @a symbol.
+  HUFFMAN_DECODE_ACCEPT = 0x02, ///< The input may end in the next state, i.e. it is valid padding.
+};
 
-Node *HUFFMAN_TREE_ROOT;
+struct huffman_decode_entry {
+  uint8_t state;
+  uint8_t flags;
+  uint8_t symbol;
+};
 
-static Node *
-make_huffman_tree_node()
-{
-  Node *n       = static_cast<Node *>(ats_malloc(sizeof(Node)));
-  n->left       = nullptr;
-  n->right      = nullptr;
-  n->ascii_code = '\0';
-  n->leaf_node  = false;
-  return n;
-}
+static constexpr int HUFFMAN_DECODE_STATES = 256;
 
-static Node *
-make_huffman_tree()
+static huffman_decode_entry huffman_decode_table[HUFFMAN_DECODE_STATES][16];
+static bool huffman_decode_table_ready = false;
+
+static void
+make_huffman_decode_table()
 {
-  Node *root = make_huffman_tree_node();
+  // Children of the internal nodes. 0 is unset (the root is never a child), values above
+  // HUFFMAN_DECODE_STATES are leaves holding the symbol.
+  uint16_t tree[HUFFMAN_DECODE_STATES][2] = {};
+  bool accept[HUFFMAN_DECODE_STATES]      = {};
+  int nodes                               = 1;
 
-  // insert leafs for each ascii code
   for (unsigned i = 0; i < countof(huffman_table); i++) {
     uint32_t bit_len = huffman_table[i].bit_len;
-    Node *current    = root;
+    uint16_t current = 0;
 
-    while (bit_len > 0) {
-      if (huffman_table[i].code_as_hex & (1 << (bit_len - 1))) {
-        if (!current->right) {
-          current->right = make_huffman_tree_node();
-        }
-        current = current->right;
-      } else {
-        if (!current->left) {
-          current->left = make_huffman_tree_node();
-        }
-        current = current->left;
+    while (bit_len > 1) {
+      int bit = (huffman_table[i].code_as_hex >> (bit_len - 1)) & 1;
+      if (tree[current][bit] == 0) {
+        ink_release_assert(nodes < HUFFMAN_DECODE_STATES);
+        tree[current][bit] = nodes++;
       }
+      current = tree[current][bit];
       bit_len--;
     }
-    current->ascii_code = i;
-    current->leaf_node  = true;
+    tree[current][huffman_table[i].code_as_hex & 1] = HUFFMAN_DECODE_STATES + i;
   }
+  ink_release_assert(nodes == HUFFMAN_DECODE_STATES);
 
-  return root;
-}
-
-static void
-free_huffman_tree(Node *node)
-{
-  if (node->left) {
-    free_huffman_tree(node->left);
-  }
-  if (node->right) {
-    free_huffman_tree(node->right);
+  // Up to 7 bits of the most significant bits of EOS (all ones) are valid padding.
+  for (int i = 0, current = 0; i < 8; i++) {
+    accept[current] = true;
+    current         = tree[current][1];
   }
 
-  ats_free(node);
+  for (int state = 0; state < HUFFMAN_DECODE_STATES; state++) {
+    for (int nibble = 0; nibble < 16; nibble++) {
+      huffman_decode_entry &e = huffman_decode_table[state][nibble];
+      int current             = state;
+
+      e = {0, 0, 0};
+      for (int shift = 3; shift >= 0; shift--) {
+        current = tree[current][(nibble >> shift) & 1];
+        if (current >= HUFFMAN_DECODE_STATES) {
+          // EOS is decoded to NUL, as the tree based decoder did.
+          e.flags  = HUFFMAN_DECODE_SYMBOL;
+          e.symbol = current - HUFFMAN_DECODE_STATES;
+          current  = 0;
+        }
+      }
+      e.state = current;
+      if (accept[current]) {
+        e.flags |= HUFFMAN_DECODE_ACCEPT;
+      }
+    }
+  }
 }
 
 void
 hpack_huffman_init()
 {
-  if (!HUFFMAN_TREE_ROOT) {
-    HUFFMAN_TREE_ROOT = make_huffman_tree();
+  if (!huffman_decode_table_ready) {
+    make_huffman_decode_table();
+    huffman_decode_table_ready = true;
   }
 }
 
 void
 hpack_huffman_fin()
 {
-  if (HUFFMAN_TREE_ROOT) {
-    free_huffman_tree(HUFFMAN_TREE_ROOT);
-  }
+  // The decode table is static, nothing to release.
 }
 
 int64_t
 huffman_decode(char *dst_start, const uint8_t *src, uint32_t src_len)
 {
-  char *dst_end             = dst_start;
-  uint8_t shift             = 7;
-  Node *current             = HUFFMAN_TREE_ROOT;
-  int byte_boundary_crossed = 0;
-  bool includes_zero        = false;
-
-  while (src_len) {
-    if (*src & (1 << shift)) {
-      current = current->right;
-    } else {
-      current       = current->left;
-      includes_zero = true;
-    }
+  char *dst_end      = dst_start;
+  const uint8_t *end = src + src_len;
+  uint8_t state      = 0;
+  bool accept        = true;
 
-    if (current->leaf_node == true) {
-      *dst_end = current->ascii_code;
-      ++dst_end;
-      current               = HUFFMAN_TREE_ROOT;
-      byte_boundary_crossed = 0;
-      includes_zero         = false;
-    }
-    if (shift) {
-      --shift;
-    } else {
-      shift = 7;
-      ++src;
-      --src_len;
-      ++byte_boundary_crossed;
+  ink_assert(huffman_decode_table_ready);
+
+  for (; src < end; ++src) {
+    const huffman_decode_entry *e = &huffman_decode_table[state][*src >> 4];
+    if (e->flags & HUFFMAN_DECODE_SYMBOL) {
+      *dst_end++ = e->symbol;
     }
-    if (byte_boundary_crossed > 3) {
-      return -1;
+    e = &huffman_decode_table[e->state][*src & 0x0f];
+    if (e->flags & HUFFMAN_DECODE_SYMBOL) {
+      *dst_end++ = e->symbol;
     }
+    state  = e->state;
+    accept = e->flags & HUFFMAN_DECODE_ACCEPT;
   }
-  if (byte_boundary_crossed > 1) {
-    return -1;
-  }
-  if (includes_zero) {
+
+  // Anything left over must be padding: shorter than a byte and all ones.
+  if (!accept) {
     return -1;
   }
 
@@ -208,36 +204,30 @@ int64_t
 huffman_encode(uint8_t *dst_start, const uint8_t *src, uint32_t src_len)
 {
   uint8_t *dst = dst_start;
-  // NOTE: The maximum length of Huffman Code is 30, thus using uint32_t as buffer.
-  uint32_t buf         = 0;
-  uint32_t remain_bits = 32;
+  // NOTE: The maximum length of Huffman Code is 30 and fewer than 32 bits are left in the accumulator
+  // after a flush, so a code always fits into a uint64_t without dropping pending bits.
+  uint64_t buf  = 0;
+  uint32_t bits = 0;
 
   for (uint32_t i = 0; i < src_len; ++i) {
-    const uint32_t hex     = huffman_table[src[i]].code_as_hex;
-    const uint32_t bit_len = huffman_table[src[i]].bit_len;
-
-    if (remain_bits > bit_len) {
-      remain_bits = remain_bits - bit_len;
-      buf |= hex << remain_bits;
-    } else if (remain_bits == bit_len) {
-      buf |= hex;
-      dst         = huffman_encode_append(dst, buf);
-      remain_bits = 32;
-      buf         = 0;
-    } else {
-      buf |= hex >> (bit_len - remain_bits);
-      dst         = huffman_encode_append(dst, buf);
-      remain_bits = (32 - (bit_len - remain_bits));
-      buf         = hex << remain_bits;
+    const huffman_entry &entry = huffman_table[src[i]];
+
+    buf = (buf << entry.bit_len) | entry.code_as_hex;
+    bits += entry.bit_len;
+    if (bits >= 32) {
+      bits -= 32;
+      dst = huffman_encode_append(dst, static_cast<uint32_t>(buf >> bits));
     }
   }
 
-  dst = huffman_encode_append(dst, buf, remain_bits / 8);
+  while (bits >= 8) {
+    bits -= 8;
+    *dst++ = static_cast<uint8_t>(buf >> bits);
+  }
 
   // NOTE: Add padding w/ EOS
-  uint32_t pad_len = remain_bits % 8;
-  if (pad_len) {
-    *(dst - 1) |= 0xff >> (8 - pad_len);
+  if (bits) {
+    *dst++ = static_cast<uint8_t>(buf << (8 - bits)) | (0xff >> bits);
   }
 
   return dst - dst_start;
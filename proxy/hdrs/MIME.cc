@@ -30,6 +30,11 @@
 #include <cstring>
 #include <cctype>
 #include <algorithm>
+#if defined(__AVX2__)
+#include <immintrin.h>
+#elif defined(__SSE2__)
+#include <emmintrin.h>
+#endif
 #include "MIME.h"
 #include "HdrHeap.h"
 #include "HdrToken.h"
@@ -1308,10 +1313,20 @@ MIMEField *
 mime_hdr_field_find(MIMEHdrImpl *mh, const char *field_name_str, int field_name_len)
 {
   HdrTokenHeapPrefix *token_info;
-  const bool is_wks = hdrtoken_is_wks(field_name_str);
+  bool is_wks = hdrtoken_is_wks(field_name_str);
 
   ink_assert(field_name_len >= 0);
 
+  // Names from plugins or other buffers are usually well-known too. Looking them up costs a hash and
+  // one compare, and then the presence bits and slot accelerators apply instead of a string walk.
+  if (!is_wks) {
+    const char *wks = nullptr;
+    if (hdrtoken_tokenize(field_name_str, field_name_len, &wks) >= 0) {
+      field_name_str = wks;
+      is_wks         = true;
+    }
+  }
+
   ////////////////////////////////////////////
   // do presence check and slot accelerator //
   ////////////////////////////////////////////
@@ -2309,6 +2324,39 @@ MIMEHdr::get_host_port_values(const char **host_ptr, ///< Pointer to host.
  *                                                                     *
  ***********************************************************************/
 
+const char *
+mime_scan_line_end(const char *s, const char *e)
+{
+#if defined(__AVX2__)
+  const __m256i lf32  = _mm256_set1_epi8(ParseRules::CHAR_LF);
+  const __m256i nul32 = _mm256_setzero_si256();
+  for (; e - s >= 32; s += 32) {
+    __m256i v     = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(s));
+    uint32_t mask = _mm256_movemask_epi8(_mm256_or_si256(_mm256_cmpeq_epi8(v, lf32), _mm256_cmpeq_epi8(v, nul32)));
+    if (mask) {
+      return s + __builtin_ctz(mask);
+    }
+  }
+#endif
+#if defined(__SSE2__)
+  const __m128i lf16  = _mm_set1_epi8(ParseRules::CHAR_LF);
+  const __m128i nul16 = _mm_setzero_si128();
+  for (; e - s >= 16; s += 16) {
+    __m128i v     = _mm_loadu_si128(reinterpret_cast<const __m128i *>(s));
+    uint32_t mask = _mm_movemask_epi8(_mm_or_si128(_mm_cmpeq_epi8(v, lf16), _mm_cmpeq_epi8(v, nul16)));
+    if (mask) {
+      return s + __builtin_ctz(mask);
+    }
+  }
+#endif
+  for (; s < e; ++s) {
+    if (*s == ParseRules::CHAR_LF || *s == '\0') {
+      break;
+    }
+  }
+  return s;
+}
+
 void
 MIMEScanner::init()
 {
@@ -2331,6 +2379,7 @@ ParseResult
 MIMEScanner::get(TextView &input, TextView &output, bool &output_shares_input, bool eof_p, ScanType scan_type)
 {
   ParseResult zret = PARSE_RESULT_CONT;
+  bool nul_p       = false; // Found a nul character, which makes the input invalid.
   // Need this for handling dangling CR.
   static const char RAW_CR{ParseRules::CHAR_CR};
 
@@ -2369,9 +2418,14 @@ MIMEScanner::get(TextView &input, TextView &output, bool &output_shares_input, b
       }
       break;
     case MIME_PARSE_INSIDE: {
-      auto lf_off = text.find(ParseRules::CHAR_LF);
-      if (lf_off != TextView::npos) {
-        text.remove_prefix(lf_off + 1); // drop up to and including LF
+      // Every byte not consumed by the other states is scanned here, so this also finds any nul.
+      const char *eol = mime_scan_line_end(text.data(), text.data_end());
+      while (eol != text.data_end() && *eol == '\0') {
+        nul_p = true;
+        eol   = mime_scan_line_end(eol + 1, text.data_end());
+      }
+      if (eol != text.data_end()) {
+        text.remove_prefix(eol - text.data() + 1); // drop up to and including LF
         if (LINE == scan_type) {
           zret    = PARSE_RESULT_OK;
           m_state = MIME_PARSE_BEFORE;
@@ -2458,7 +2512,7 @@ MIMEScanner::get(TextView &input, TextView &output, bool &output_shares_input, b
   }
 
   // Make sure there are no null characters in the input scanned so far
-  if (zret != PARSE_RESULT_ERROR && TextView::npos != parsed_text.find('\0')) {
+  if (zret != PARSE_RESULT_ERROR && nul_p) {
     zret = PARSE_RESULT_ERROR;
   }
 
@@ -2954,8 +3008,8 @@ mime_days_since_epoch_to_mdy(unsigned int days_since_jan_1_1970, int *m_return,
   mime_days_since_epoch_to_mdy_slowcase(days_since_jan_1_1970, m_return, d_return, y_return);
 }
 
-int
-mime_format_date(char *buffer, time_t value)
+static int
+mime_format_date_uncached(char *buffer, time_t value)
 {
   // must be 3 characters!
   static const char *daystrs[] = {"Sun", "Mon", "Tue", "Wed", "Thu", "Fri", "Sat"};
@@ -3076,6 +3130,22 @@ mime_format_date(char *buffer, time_t value)
   return buf - buffer; // not counting NUL
 }
 
+int
+mime_format_date(char *buffer, time_t value)
+{
+  // Nearly every call formats the current second (the Date header), so each thread keeps the last result.
+  static thread_local time_t last_value = 0;
+  static thread_local int last_length   = 0;
+  static thread_local char last_date[32];
+
+  if (last_length == 0 || value != last_value) {
+    last_length = mime_format_date_uncached(last_date, value);
+    last_value  = value;
+  }
+  memcpy(buffer, last_date, last_length + 1);
+  return last_length;
+}
+
 int32_t
 mime_parse_int(const char *buf, const char *end)
 {
@@ -3206,171 +3276,142 @@ mime_parse_int64(const char *buf, const char *end)
 
   mime_parse_rfc822_date_fastcase (const char *buf, int length, struct tm *tp)
 
-  This routine is a fast case parser for date strings that are guaranteed
-  to be in the rfc822/rfc1123 format.  It uses integer binary searches to
-  convert daya and month names into integral indices.
-
-  This routine only supports rfc822/rfc1123 dates.  It must be called
-  with NO leading whitespace, with a length >= 29 characters, and with
-  a comma in buf[3].  The caller MUST ensure these conditions.
+  This routine is a fast case parser for date strings in the exact
+  fixed layout that rfc1123 recommends and that nearly every server
+  sends (and mime_format_date produces):
 
         Sun, 06 Nov 1994 08:49:37 GMT
         01234567890123456789012345678
 
-  This function handles the common case dates fast.  The day and month
-  are processed as 3 character integers before falling to DFA.  This
-  table shows string, hash (24 bit values of 3 characters), and the
-  resulting string index.
-
-        Fri 0x467269 5    Apr 0x417072 3
-        Mon 0x4D6F6E 1    Aug 0x417567 7
-        Sat 0x536174 6    Dec 0x446563 11
-        Sun 0x53756E 0    Feb 0x466562 1
-        Thu 0x546875 4    Jan 0x4A616E 0
-        Tue 0x547565 2    Jul 0x4A756C 6
-        Wed 0x576564 3    Jun 0x4A756E 5
-                          Mar 0x4D6172 2
-                          May 0x4D6179 4
-                          Nov 0x4E6F76 10
-                          Oct 0x4F6374 9
-                          Sep 0x536570 8
+  It must be called with NO leading whitespace and with a length >= 29
+  characters.  Every position is checked, the digits and separators
+  without branches, and the day and month names are found with a
+  perfect hash of their last two characters followed by a single
+  compare against the name in that slot.  Anything else, including
+  names in another case, returns 0 and is left to the general parser.
 
   -------------------------------------------------------------------------*/
+
+static constexpr uint32_t
+mime_date_name(const char *name)
+{
+  return (static_cast<uint32_t>(static_cast<unsigned char>(name[0])) << 16) |
+         (static_cast<uint32_t>(static_cast<unsigned char>(name[1])) << 8) | static_cast<unsigned char>(name[2]);
+}
+
+static constexpr unsigned
+mime_date_wday_slot(unsigned char c1, unsigned char c2)
+{
+  return (c1 + 2 * c2) & 15;
+}
+
+static constexpr unsigned
+mime_date_month_slot(unsigned char c1, unsigned char c2)
+{
+  return (c1 + c2) & 31;
+}
+
+template <unsigned N> struct MimeDateNameTable {
+  uint32_t name[N] = {}; ///< Packed three character name, 0 if the slot is empty.
+  int8_t index[N]  = {};
+  bool valid       = true;
+};
+
+template <unsigned N, unsigned K>
+static constexpr MimeDateNameTable<N>
+mime_date_build_name_table(const char *const (&names)[K], unsigned (*slot_of)(unsigned char, unsigned char))
+{
+  MimeDateNameTable<N> table;
+  for (unsigned i = 0; i < K; ++i) {
+    unsigned slot = slot_of(names[i][1], names[i][2]);
+    if (table.name[slot] != 0) {
+      table.valid = false;
+    }
+    table.name[slot]  = mime_date_name(names[i]);
+    table.index[slot] = i;
+  }
+  return table;
+}
+
+static constexpr const char *mime_date_wday_names[]  = {"Sun", "Mon", "Tue", "Wed", "Thu", "Fri", "Sat"};
+static constexpr const char *mime_date_month_names[] = {"Jan", "Feb", "Mar", "Apr", "May", "Jun",
+                                                        "Jul", "Aug", "Sep", "Oct", "Nov", "Dec"};
+
+static constexpr MimeDateNameTable<16> mime_date_wday_table =
+  mime_date_build_name_table<16>(mime_date_wday_names, mime_date_wday_slot);
+static constexpr MimeDateNameTable<32> mime_date_month_table =
+  mime_date_build_name_table<32>(mime_date_month_names, mime_date_month_slot);
+static_assert(mime_date_wday_table.valid, "day names collide, change mime_date_wday_slot");
+static_assert(mime_date_month_table.valid, "month names collide, change mime_date_month_slot");
+
 int
 mime_parse_rfc822_date_fastcase(const char *buf, int length, struct tm *tp)
 {
-  unsigned int three_char_wday, three_char_mon;
-  std::string_view view{buf, size_t(length)};
+  const unsigned char *b = reinterpret_cast<const unsigned char *>(buf);
+  unsigned bad           = 0;
 
   ink_assert(length >= 29);
   ink_assert(!is_ws(buf[0]));
-  ink_assert(buf[3] == ',');
-
-  ////////////////////////////
-  // binary search for wday //
-  ////////////////////////////
-  tp->tm_wday     = -1;
-  three_char_wday = (buf[0] << 16) | (buf[1] << 8) | buf[2];
-  if (three_char_wday <= 0x53756E) {
-    if (three_char_wday == 0x467269) {
-      tp->tm_wday = 5;
-    } else if (three_char_wday == 0x4D6F6E) {
-      tp->tm_wday = 1;
-    } else if (three_char_wday == 0x536174) {
-      tp->tm_wday = 6;
-    } else if (three_char_wday == 0x53756E) {
-      tp->tm_wday = 0;
-    }
-  } else {
-    if (three_char_wday == 0x546875) {
-      tp->tm_wday = 4;
-    } else if (three_char_wday == 0x547565) {
-      tp->tm_wday = 2;
-    } else if (three_char_wday == 0x576564) {
-      tp->tm_wday = 3;
-    }
-  }
-  if (tp->tm_wday < 0) {
-    tp->tm_wday = day_names_dfa->match(view);
-    if (tp->tm_wday < 0) {
-      return 0;
-    }
-  }
-  //////////////////////////
-  // extract day of month //
-  //////////////////////////
-  tp->tm_mday = (buf[5] - '0') * 10 + (buf[6] - '0');
-
-  /////////////////////////////
-  // binary search for month //
-  /////////////////////////////
-  tp->tm_mon     = -1;
-  three_char_mon = (buf[8] << 16) | (buf[9] << 8) | buf[10];
-  if (three_char_mon <= 0x4A756C) {
-    if (three_char_mon <= 0x446563) {
-      if (three_char_mon == 0x417072) {
-        tp->tm_mon = 3;
-      } else if (three_char_mon == 0x417567) {
-        tp->tm_mon = 7;
-      } else if (three_char_mon == 0x446563) {
-        tp->tm_mon = 11;
-      }
-    } else {
-      if (three_char_mon == 0x466562) {
-        tp->tm_mon = 1;
-      } else if (three_char_mon == 0x4A616E) {
-        tp->tm_mon = 0;
-      } else if (three_char_mon == 0x4A756C) {
-        tp->tm_mon = 6;
-      }
-    }
-  } else {
-    if (three_char_mon <= 0x4D6179) {
-      if (three_char_mon == 0x4A756E) {
-        tp->tm_mon = 5;
-      } else if (three_char_mon == 0x4D6172) {
-        tp->tm_mon = 2;
-      } else if (three_char_mon == 0x4D6179) {
-        tp->tm_mon = 4;
-      }
-    } else {
-      if (three_char_mon == 0x4E6F76) {
-        tp->tm_mon = 10;
-      } else if (three_char_mon == 0x4F6374) {
-        tp->tm_mon = 9;
-      } else if (three_char_mon == 0x536570) {
-        tp->tm_mon = 8;
-      }
-    }
-  }
-  if (tp->tm_mon < 0) {
-    tp->tm_mon = month_names_dfa->match(view);
-    if (tp->tm_mon < 0) {
-      return 0;
-    }
+
+  for (int i : {5, 6, 12, 13, 14, 15, 17, 18, 20, 21, 23, 24}) {
+    bad |= (static_cast<unsigned>(b[i] - '0') > 9u);
   }
-  //////////////////
-  // extract year //
-  //////////////////
-  tp->tm_year = ((buf[12] - '0') * 1000 + (buf[13] - '0') * 100 + (buf[14] - '0') * 10 + (buf[15] - '0')) - 1900;
+  bad |= (b[3] ^ ',') | (b[4] ^ ' ') | (b[7] ^ ' ') | (b[11] ^ ' ') | (b[16] ^ ' ') | (b[19] ^ ':') | (b[22] ^ ':') |
+         (b[25] ^ ' ') | (b[26] ^ 'G') | (b[27] ^ 'M') | (b[28] ^ 'T');
+
+  unsigned wday_slot  = mime_date_wday_slot(b[1], b[2]);
+  unsigned month_slot = mime_date_month_slot(b[9], b[10]);
+  bad |= mime_date_wday_table.name[wday_slot] ^ mime_date_name(buf);
+  bad |= mime_date_month_table.name[month_slot] ^ mime_date_name(buf + 8);
 
-  //////////////////
-  // extract time //
-  //////////////////
-  tp->tm_hour = (buf[17] - '0') * 10 + (buf[18] - '0');
-  tp->tm_min  = (buf[20] - '0') * 10 + (buf[21] - '0');
-  tp->tm_sec  = (buf[23] - '0') * 10 + (buf[24] - '0');
-  if ((buf[19] != ':') || (buf[22] != ':')) {
+  if (bad) {
     return 0;
   }
+
+  tp->tm_wday = mime_date_wday_table.index[wday_slot];
+  tp->tm_mon  = mime_date_month_table.index[month_slot];
+  tp->tm_mday = (b[5] - '0') * 10 + (b[6] - '0');
+  tp->tm_year = ((b[12] - '0') * 1000 + (b[13] - '0') * 100 + (b[14] - '0') * 10 + (b[15] - '0')) - 1900;
+  tp->tm_hour = (b[17] - '0') * 10 + (b[18] - '0');
+  tp->tm_min  = (b[20] - '0') * 10 + (b[21] - '0');
+  tp->tm_sec  = (b[23] - '0') * 10 + (b[24] - '0');
   return 1;
 }
 
-/*-------------------------------------------------------------------------
-   Sun, 06 Nov 1994 08:49:37 GMT  ; RFC 822, updated by RFC 1123
-   Sunday, 06-Nov-94 08:49:37 GMT ; RFC 850, obsoleted by RFC 1036
-   Sun Nov  6 08:49:37 1994       ; ANSI C's asctime() format
-   6 Nov 1994 08:49:37 GMT        ; NNTP-style date
-  -------------------------------------------------------------------------*/
-time_t
-mime_parse_date(const char *buf, const char *end)
+static time_t
+mime_date_tm_to_time(const struct tm &tp)
 {
   static const int DAYS_OFFSET = 25508;
   static const int days[12]    = {305, 336, -1, 30, 60, 91, 121, 152, 183, 213, 244, 274};
 
-  struct tm tp;
-  time_t t;
-  int year;
-  int month;
-  int mday;
+  int year  = tp.tm_year;
+  int month = tp.tm_mon;
+  int mday  = tp.tm_mday;
 
-  if (!buf) {
+  // what should we do?
+  if (year > 137) {
+    return (time_t)INT_MAX;
+  }
+  if (year < 70) {
     return (time_t)0;
   }
 
-  while ((buf != end) && is_ws(*buf)) {
-    buf += 1;
+  mday += days[month];
+  /* month base == march */
+  if (month < 2) {
+    year -= 1;
   }
+  mday += (year * 365) + (year / 4) - (year / 100) + (year / 100 + 3) / 4;
+  mday -= DAYS_OFFSET;
+
+  return ((mday * 24 + tp.tm_hour) * 60 + tp.tm_min) * 60 + tp.tm_sec;
+}
+
+/// Parse any date format other than the fixed rfc1123 layout, @a buf has no leading whitespace.
+static time_t
+mime_parse_date_slowcase(const char *buf, const char *end)
+{
+  struct tm tp;
 
   if ((buf != end) && is_digit(*buf)) { // NNTP date
     if (!mime_parse_mday(buf, end, &tp.tm_mday)) {
@@ -3385,10 +3426,6 @@ mime_parse_date(const char *buf, const char *end)
     if (!mime_parse_time(buf, end, &tp.tm_hour, &tp.tm_min, &tp.tm_sec)) {
       return (time_t)0;
     }
-  } else if (end && (end - buf >= 29) && (buf[3] == ',')) {
-    if (!mime_parse_rfc822_date_fastcase(buf, end - buf, &tp)) {
-      return (time_t)0;
-    }
   } else {
     if (!mime_parse_day(buf, end, &tp.tm_wday)) {
       return (time_t)0;
@@ -3430,27 +3467,67 @@ mime_parse_date(const char *buf, const char *end)
     }
   }
 
-  year  = tp.tm_year;
-  month = tp.tm_mon;
-  mday  = tp.tm_mday;
+  return mime_date_tm_to_time(tp);
+}
 
-  // what should we do?
-  if (year > 137) {
-    return (time_t)INT_MAX;
-  }
-  if (year < 70) {
+// Dates that are not in the fixed rfc1123 layout look their names up through the DFA. Servers that send
+// them send the same few strings over and over (e.g. an Expires date), so each thread remembers the
+// results for the last strings it parsed.
+
+static constexpr int MIME_DATE_CACHE_SIZE    = 16;
+static constexpr int MIME_DATE_CACHE_MAX_LEN = 47;
+
+struct MimeDateCacheEntry {
+  char str[MIME_DATE_CACHE_MAX_LEN];
+  uint8_t length = 0; ///< 0 if the entry is empty.
+  time_t value   = 0;
+};
+
+static thread_local MimeDateCacheEntry mime_date_cache[MIME_DATE_CACHE_SIZE];
+
+/*-------------------------------------------------------------------------
+   Sun, 06 Nov 1994 08:49:37 GMT  ; RFC 822, updated by RFC 1123
+   Sunday, 06-Nov-94 08:49:37 GMT ; RFC 850, obsoleted by RFC 1036
+   Sun Nov  6 08:49:37 1994       ; ANSI C's asctime() format
+   6 Nov 1994 08:49:37 GMT        ; NNTP-style date
+  -------------------------------------------------------------------------*/
+time_t
+mime_parse_date(const char *buf, const char *end)
+{
+  struct tm tp;
+
+  if (!buf) {
     return (time_t)0;
   }
 
-  mday += days[month];
-  /* month base == march */
-  if (month < 2) {
-    year -= 1;
+  while ((buf != end) && is_ws(*buf)) {
+    buf += 1;
   }
-  mday += (year * 365) + (year / 4) - (year / 100) + (year / 100 + 3) / 4;
-  mday -= DAYS_OFFSET;
 
-  t = ((mday * 24 + tp.tm_hour) * 60 + tp.tm_min) * 60 + tp.tm_sec;
+  if (end && (end - buf >= 29) && mime_parse_rfc822_date_fastcase(buf, end - buf, &tp)) {
+    return mime_date_tm_to_time(tp);
+  }
+
+  MimeDateCacheEntry *entry = nullptr;
+  if (end && (end - buf > 0) && (end - buf <= MIME_DATE_CACHE_MAX_LEN)) {
+    int length    = end - buf;
+    uint32_t hash = length;
+    for (int i = 0; i < length; ++i) {
+      hash = hash * 33 + static_cast<unsigned char>(buf[i]);
+    }
+    entry = &mime_date_cache[hash % MIME_DATE_CACHE_SIZE];
+    if (entry->length == length && memcmp(entry->str, buf, length) == 0) {
+      return entry->value;
+    }
+  }
+
+  time_t t = mime_parse_date_slowcase(buf, end);
+
+  if (entry) {
+    entry->length = end - buf;
+    entry->value  = t;
+    memcpy(entry->str, buf, entry->length);
+  }
 
   return t;
 }
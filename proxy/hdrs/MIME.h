@@ -755,6 +755,15 @@ void mime_field_name_value_set(HdrHeap *heap, MIMEHdrImpl *mh, MIMEField *field,
 void mime_field_value_append(HdrHeap *heap, MIMEHdrImpl *mh, MIMEField *field, const char *value, int length, bool prepend_comma,
                              const char separator);
 
+/** Find the end of a MIME line in [@a s, @a e).
+ *
+ * @return A pointer to the first LF or nul character, or @a e if there is neither.
+ *
+ * Both are looked for in a single pass, vectorized where the target supports it, because nul
+ * characters are not allowed anywhere in a header and every scanned byte must be checked for them.
+ */
+const char *mime_scan_line_end(const char *s, const char *e);
+
 void mime_parser_init(MIMEParser *parser);
 void mime_parser_clear(MIMEParser *parser);
 ParseResult mime_parser_parse(MIMEParser *parser, HdrHeap *heap, MIMEHdrImpl *mh, const char **real_s, const char *real_e,
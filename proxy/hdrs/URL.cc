@@ -22,6 +22,7 @@
  */
 
 #include <cassert>
+#include <atomic>
 #include <new>
 #include "tscore/ink_platform.h"
 #include "tscore/ink_memory.h"
@@ -98,6 +99,23 @@ int URL_LEN_MMST;
 // url_CryptoHash_get_fast() does NOT produce the same result as url_CryptoHash_get_general().
 static int url_hash_method = 0;
 
+// URLImpl::m_stamp values are handed out to threads in blocks, so they
+// are unique without an atomic operation on every change of a URL.
+static constexpr uint32_t URL_STAMP_BLOCK = 1024;
+static std::atomic<uint32_t> url_stamp_block{0};
+static thread_local uint32_t url_stamp_next = 0;
+static thread_local uint32_t url_stamp_end  = 0;
+
+static inline uint32_t
+url_new_stamp()
+{
+  if (url_stamp_next == url_stamp_end) {
+    url_stamp_next = url_stamp_block.fetch_add(URL_STAMP_BLOCK, std::memory_order_relaxed);
+    url_stamp_end  = url_stamp_next + URL_STAMP_BLOCK;
+  }
+  return url_stamp_next++;
+}
+
 // test to see if a character is a valid character for a host in a URI according to
 // RFC 3986 and RFC 1034
 inline static int
@@ -215,6 +233,7 @@ url_create(HdrHeap *heap)
   obj_clear_data((HdrHeapObjImpl *)url);
   url->m_url_type       = URL_TYPE_NONE;
   url->m_scheme_wks_idx = -1;
+  url->m_stamp          = url_new_stamp();
   url_clear_string_ref(url);
   return url;
 }
@@ -228,6 +247,7 @@ url_clear(URLImpl *url_impl)
   obj_clear_data((HdrHeapObjImpl *)url_impl);
   url_impl->m_url_type       = URL_TYPE_NONE;
   url_impl->m_scheme_wks_idx = -1;
+  url_impl->m_stamp          = url_new_stamp();
 }
 
 /*-------------------------------------------------------------------------
@@ -249,6 +269,7 @@ url_copy_onto(URLImpl *s_url, HdrHeap *s_heap, URLImpl *d_url, HdrHeap *d_heap,
 {
   if (s_url != d_url) {
     obj_copy_data((HdrHeapObjImpl *)s_url, (HdrHeapObjImpl *)d_url);
+    d_url->m_stamp = url_new_stamp();
     if (inherit_strs && (s_heap != d_heap)) {
       d_heap->inherit_string_heaps(s_heap);
     }
@@ -275,6 +296,7 @@ url_nuke_proxy_stuff(URLImpl *d_url)
 
   d_url->m_scheme_wks_idx = -1;
   d_url->m_port           = 0;
+  d_url->m_stamp          = url_new_stamp();
 }
 
 /*-------------------------------------------------------------------------
@@ -597,6 +619,7 @@ void
 url_called_set(URLImpl *url)
 {
   url->m_clean = !url->m_ptr_printed_string;
+  url->m_stamp = url_new_stamp();
 }
 
 void
@@ -76,6 +76,10 @@ struct URLImpl : public HdrHeapObjImpl {
   uint32_t m_clean : 1;
   // 8 bytes + 1 bit, will result in padding
 
+  // Set to a fresh value by every change of the URL, see url_called_set().
+  // It takes up what used to be padding, marshalled URLs keep their layout
+  uint32_t m_stamp;
+
   // Marshaling Functions
   int marshal(MarshalXlate *str_xlate, int num_xlate);
   void unmarshal(intptr_t offset);
@@ -442,6 +446,51 @@ URL::host_hash_get(CryptoHash *hash)
   url_host_CryptoHash_get(m_url_impl, hash);
 }
 
+/*-------------------------------------------------------------------------
+  -------------------------------------------------------------------------*/
+
+/** Keeps the cache key hash of the URL last hashed through it.
+
+    Normalizing and digesting a URL for its cache key costs about as much as printing it, and a transaction
+    needs the key for the cache lookup, again for the cache write and plugins may want it too. The hash is
+    reused as long as the same @c URLImpl is hashed with the same generation and has not changed since,
+    which @c URLImpl::m_stamp tracks. The owner must keep the heap of the URL alive while using the cache,
+    so a @c URLImpl address is not reused under it.
+ */
+class URLHashCache
+{
+public:
+  void get(const URL *url, CryptoHash *hash, cache_generation_t generation = -1);
+  void clear();
+
+private:
+  const URLImpl *m_url            = nullptr;
+  uint32_t m_stamp                = 0;
+  cache_generation_t m_generation = -1;
+  CryptoHash m_hash;
+};
+
+inline void
+URLHashCache::get(const URL *url, CryptoHash *hash, cache_generation_t generation)
+{
+  ink_assert(url->valid());
+  const URLImpl *impl = url->m_url_impl;
+
+  if (impl != m_url || impl->m_stamp != m_stamp || generation != m_generation) {
+    url_CryptoHash_get(impl, &m_hash, generation);
+    m_url        = impl;
+    m_stamp      = impl->m_stamp;
+    m_generation = generation;
+  }
+  *hash = m_hash;
+}
+
+inline void
+URLHashCache::clear()
+{
+  m_url = nullptr;
+}
+
 /*-------------------------------------------------------------------------
   -------------------------------------------------------------------------*/
 
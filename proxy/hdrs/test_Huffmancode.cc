@@ -26,6 +26,7 @@
 #include <iostream>
 #include <cassert>
 #include <cstring>
+#include <chrono>
 
 using namespace std;
 
@@ -171,8 +172,89 @@ encode_test()
   }
 }
 
+void
+decode_test()
+{
+  char dst[64];
+
+  for (const auto &i : huffman_encode_test_data) {
+    int64_t decoded_len = huffman_decode(dst, i.expect, i.expect_len);
+
+    assert(decoded_len == i.src_len);
+    assert(memcmp(i.src, dst, decoded_len) == 0);
+  }
+
+  // "0" is 00000, the padding must be at most 7 bits of ones.
+  assert(huffman_decode(dst, (const uint8_t *)"\x07", 1) == 1);
+  assert(huffman_decode(dst, (const uint8_t *)"\x07\xff", 2) == -1);
+  assert(huffman_decode(dst, (const uint8_t *)"\x06", 1) == -1);
+  assert(huffman_decode(dst, (const uint8_t *)"\xff", 1) == -1);
+}
+
+void
+round_trip_test()
+{
+  const int size = 1024;
+  uint8_t src[size];
+  uint8_t encoded[size * 4];
+  char decoded[size];
+
+  for (int len = 0; len <= size; len += 7) {
+    for (int i = 0; i < len; i++) {
+      // coverity[dont_call]
+      src[i] = (uint8_t)lrand48();
+    }
+
+    int64_t encoded_len = huffman_encode(encoded, src, len);
+    int64_t decoded_len = huffman_decode(decoded, encoded, encoded_len);
+
+    assert(decoded_len == len);
+    assert(memcmp(src, decoded, len) == 0);
+  }
+}
+
+// Not part of the regular test run, use "test_Huffmancode benchmark".
+void
+benchmark()
+{
+  const char *header_values[] = {
+    "Mozilla/5.0 (Macintosh; Intel Mac OS X 10_15_7) AppleWebKit/537.36 (KHTML, like Gecko) Chrome/120.0.0.0 Safari/537.36",
+    "text/html,application/xhtml+xml,application/xml;q=0.9,image/avif,image/webp,*/*;q=0.8",
+    "gzip, deflate, br",
+    "https://www.example.com/path/to/some/resource?query=string&with=parameters",
+    "Mon, 21 Oct 2013 20:13:21 GMT",
+    "max-age=31536000, public",
+  };
+  const int rounds = 200000;
+  uint8_t encoded[256];
+  char decoded[256];
+  size_t bytes = 0;
+
+  auto start = chrono::steady_clock::now();
+  for (int r = 0; r < rounds; r++) {
+    for (const char *value : header_values) {
+      int64_t len = huffman_encode(encoded, (const uint8_t *)value, strlen(value));
+      bytes += len;
+    }
+  }
+  auto encode_ns = chrono::duration_cast<chrono::nanoseconds>(chrono::steady_clock::now() - start).count();
+
+  size_t decoded_bytes = 0;
+  start                = chrono::steady_clock::now();
+  for (const char *value : header_values) {
+    int64_t len = huffman_encode(encoded, (const uint8_t *)value, strlen(value));
+    for (int r = 0; r < rounds; r++) {
+      decoded_bytes += huffman_decode(decoded, encoded, len);
+    }
+  }
+  auto decode_ns = chrono::duration_cast<chrono::nanoseconds>(chrono::steady_clock::now() - start).count();
+
+  cout << "encode: " << (double)encode_ns / bytes << " ns/byte" << endl;
+  cout << "decode: " << (double)decode_ns / decoded_bytes << " ns/byte" << endl;
+}
+
 int
-main()
+main(int argc, const char **argv)
 {
   hpack_huffman_init();
 
@@ -180,6 +262,12 @@ main()
     random_test();
   }
   values_test();
+  decode_test();
+  round_trip_test();
+
+  if (argc > 1 && strcmp(argv[1], "benchmark") == 0) {
+    benchmark();
+  }
 
   hpack_huffman_fin();
 
@@ -18,6 +18,9 @@
    the License.
  */
 
+#include <cstring>
+#include <string_view>
+
 #include "catch.hpp"
 
 #include "HdrHeap.h"
@@ -130,3 +133,96 @@ TEST_CASE("HdrHeap", "[proxy][hdrheap]")
   // Clean up
   heap->destroy();
 }
+
+/**
+  Inheriting the string heaps of the same source again, as happens when a header is copied
+  onto one that was copied from the same source before, must share the already attached
+  heaps instead of taking more slots and coalescing.
+ */
+TEST_CASE("HdrHeap inherit shared", "[proxy][hdrheap]")
+{
+  HdrHeap *src = new_HdrHeap();
+  HdrHeap *dst = new_HdrHeap();
+
+  URLImpl *src_url = url_create(src);
+  url_path_set(src, src_url, "first/path", 10, true);
+  REQUIRE(src->m_read_write_heap.get() != nullptr);
+
+  uint64_t coalesce = hdr_heap_stats.str_coalesce.load();
+  uint64_t shared   = hdr_heap_stats.str_inherit_shared.load();
+
+  dst->inherit_string_heaps(src);
+  CHECK(dst->m_ronly_heap[0].m_ref_count_ptr.get() == src->m_read_write_heap.get());
+  CHECK(dst->m_ronly_heap[0].m_heap_len == 10);
+  CHECK(dst->m_ronly_heap[1].m_heap_start == nullptr);
+
+  // The source grew since, the shared slot has to cover the new strings too
+  url_host_set(src, src_url, "www.example.com", 15, true);
+  for (unsigned i = 0; i < HDR_BUF_RONLY_HEAPS + 1; ++i) {
+    dst->inherit_string_heaps(src);
+  }
+  CHECK(dst->m_ronly_heap[0].m_heap_len == 25);
+  CHECK(dst->m_ronly_heap[0].contains(src_url->m_ptr_host));
+  CHECK(dst->m_ronly_heap[1].m_heap_start == nullptr);
+  CHECK(dst->m_read_write_heap.get() == nullptr);
+  CHECK(hdr_heap_stats.str_coalesce.load() == coalesce);
+  CHECK(hdr_heap_stats.str_inherit_shared.load() == shared + HDR_BUF_RONLY_HEAPS + 1);
+
+  dst->destroy();
+  src->destroy();
+}
+
+TEST_CASE("HdrHeap large heaps", "[proxy][hdrheap]")
+{
+  HdrHeap *heap = new_HdrHeap(HdrHeap::LARGE_SIZE);
+  CHECK(heap->m_size == static_cast<uint32_t>(HdrHeap::LARGE_SIZE));
+
+  // Fill the first heap so that the overflow heap, twice the size, is chained
+  while (heap->m_next == nullptr) {
+    url_create(heap);
+  }
+  CHECK(heap->m_next->m_size == static_cast<uint32_t>(HdrHeap::LARGE_SIZE * 2));
+
+  char *str = heap->allocate_str(HdrStrHeap::DEFAULT_SIZE);
+  REQUIRE(str != nullptr);
+  CHECK(heap->m_read_write_heap->m_heap_size == static_cast<uint32_t>(HdrStrHeap::LARGE_SIZE));
+
+  heap->destroy();
+}
+
+TEST_CASE("HdrHeap marshal compact", "[proxy][hdrheap]")
+{
+  HdrHeap *heap = new_HdrHeap();
+  URLImpl *url  = url_create(heap);
+
+  // Leave a long dead path behind in the read-write heap
+  char long_path[1024];
+  memset(long_path, 'x', sizeof(long_path));
+  url_path_set(heap, url, long_path, sizeof(long_path), true);
+  url_path_set(heap, url, "short/path", 10, true);
+  url_host_set(heap, url, "www.example.com", 15, true);
+
+  uint64_t compact = hdr_heap_stats.marshal_compact.load();
+  uint64_t dropped = hdr_heap_stats.marshal_compact_bytes.load();
+
+  int len = heap->marshal_length();
+  CHECK(len < static_cast<int>(sizeof(long_path)));
+
+  alignas(HDR_PTR_SIZE) char buf[HdrHeap::DEFAULT_SIZE * 2];
+  REQUIRE(len <= static_cast<int>(sizeof(buf)));
+  CHECK(heap->marshal(buf, sizeof(buf)) == len);
+  CHECK(hdr_heap_stats.marshal_compact.load() == compact + 1);
+  CHECK(hdr_heap_stats.marshal_compact_bytes.load() == dropped + sizeof(long_path));
+
+  HdrHeap *copy       = reinterpret_cast<HdrHeap *>(buf);
+  HdrHeapObjImpl *obj = nullptr;
+  REQUIRE(copy->unmarshal(len, HDR_HEAP_OBJ_URL, &obj, nullptr) == len);
+  REQUIRE(obj != nullptr);
+
+  URLImpl *copy_url = static_cast<URLImpl *>(obj);
+  CHECK(std::string_view(copy_url->m_ptr_path, copy_url->m_len_path) == "short/path");
+  CHECK(std::string_view(copy_url->m_ptr_host, copy_url->m_len_host) == "www.example.com");
+  CHECK(copy->m_ronly_heap[0].m_heap_len == 25);
+
+  heap->destroy();
+}
@@ -55,6 +55,39 @@ RecRawStatBlock *http_rsb;
     RecSetRawStatCount(http_rsb, x, 0); \
   } while (0);
 
+// The header heap counters live in libhdrs, which has no stat block of its own.
+static int
+hdr_heap_stat_sync(const char *, RecDataT data_type, RecData *data, RecRawStatBlock *, int id)
+{
+  uint64_t value = 0;
+
+  switch (id) {
+  case http_hdr_heap_str_coalesce_stat:
+    value = hdr_heap_stats.str_coalesce.load(std::memory_order_relaxed);
+    break;
+  case http_hdr_heap_str_coalesce_bytes_stat:
+    value = hdr_heap_stats.str_coalesce_bytes.load(std::memory_order_relaxed);
+    break;
+  case http_hdr_heap_str_demote_stat:
+    value = hdr_heap_stats.str_demote.load(std::memory_order_relaxed);
+    break;
+  case http_hdr_heap_str_inherit_shared_stat:
+    value = hdr_heap_stats.str_inherit_shared.load(std::memory_order_relaxed);
+    break;
+  case http_hdr_heap_marshal_compact_stat:
+    value = hdr_heap_stats.marshal_compact.load(std::memory_order_relaxed);
+    break;
+  case http_hdr_heap_marshal_compact_bytes_stat:
+    value = hdr_heap_stats.marshal_compact_bytes.load(std::memory_order_relaxed);
+    break;
+  default:
+    break;
+  }
+  RecDataSetFromInt64(data_type, data, value);
+
+  return REC_ERR_OKAY;
+}
+
 class HttpConfigCont : public Continuation
 {
 public:
@@ -901,6 +934,19 @@ register_stat_callbacks()
                      (int)http_sm_start_time_stat, RecRawStatSyncSum);
   RecRegisterRawStat(http_rsb, RECT_PROCESS, "proxy.process.http.milestone.sm_finish", RECD_COUNTER, RECP_PERSISTENT,
                      (int)http_sm_finish_time_stat, RecRawStatSyncSum);
+
+  RecRegisterRawStat(http_rsb, RECT_PROCESS, "proxy.process.http.hdr_heap.str_coalesce", RECD_COUNTER, RECP_NON_PERSISTENT,
+                     (int)http_hdr_heap_str_coalesce_stat, hdr_heap_stat_sync);
+  RecRegisterRawStat(http_rsb, RECT_PROCESS, "proxy.process.http.hdr_heap.str_coalesce_bytes", RECD_COUNTER, RECP_NON_PERSISTENT,
+                     (int)http_hdr_heap_str_coalesce_bytes_stat, hdr_heap_stat_sync);
+  RecRegisterRawStat(http_rsb, RECT_PROCESS, "proxy.process.http.hdr_heap.str_demote", RECD_COUNTER, RECP_NON_PERSISTENT,
+                     (int)http_hdr_heap_str_demote_stat, hdr_heap_stat_sync);
+  RecRegisterRawStat(http_rsb, RECT_PROCESS, "proxy.process.http.hdr_heap.str_inherit_shared", RECD_COUNTER, RECP_NON_PERSISTENT,
+                     (int)http_hdr_heap_str_inherit_shared_stat, hdr_heap_stat_sync);
+  RecRegisterRawStat(http_rsb, RECT_PROCESS, "proxy.process.http.hdr_heap.marshal_compact", RECD_COUNTER, RECP_NON_PERSISTENT,
+                     (int)http_hdr_heap_marshal_compact_stat, hdr_heap_stat_sync);
+  RecRegisterRawStat(http_rsb, RECT_PROCESS, "proxy.process.http.hdr_heap.marshal_compact_bytes", RECD_COUNTER,
+                     RECP_NON_PERSISTENT, (int)http_hdr_heap_marshal_compact_bytes_stat, hdr_heap_stat_sync);
 }
 
 static bool
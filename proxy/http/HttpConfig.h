@@ -328,6 +328,14 @@ enum {
 
   http_origin_connections_throttled_stat,
 
+  // header heap maintenance, synced from hdr_heap_stats
+  http_hdr_heap_str_coalesce_stat,
+  http_hdr_heap_str_coalesce_bytes_stat,
+  http_hdr_heap_str_demote_stat,
+  http_hdr_heap_str_inherit_shared_stat,
+  http_hdr_heap_marshal_compact_stat,
+  http_hdr_heap_marshal_compact_bytes_stat,
+
   http_stat_count
 };
 
@@ -152,6 +152,8 @@ HttpDebugNames::get_event_name(int event)
   case NET_EVENT_OPEN_FAILED:
     static_assert(static_cast<int>(NET_EVENT_OPEN_FAILED) == static_cast<int>(TS_EVENT_NET_CONNECT_FAILED));
     return "NET_EVENT_OPEN_FAILED/TS_EVENT_NET_CONNECT_FAILED";
+  case NET_EVENT_SPLICE_DONE:
+    return "NET_EVENT_SPLICE_DONE";
 
   ////////////////////
   // HOSTDB  EVENTS //
@@ -167,6 +167,7 @@ make_net_accept_options(const HttpProxyPort *port, unsigned nthreads)
     net.ip_family             = port->m_family;
     net.local_port            = port->m_port;
     net.f_proxy_protocol      = port->m_proxy_protocol;
+    net.thread_fds            = port->m_thread_fds;
 
     if (port->m_inbound_ip.isValid()) {
       net.local_ip = port->m_inbound_ip;
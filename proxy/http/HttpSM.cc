@@ -2869,6 +2869,31 @@ HttpSM::tunnel_handler(int event, void *data)
   return 0;
 }
 
+int
+HttpSM::tunnel_handler_splice(int event, void *data)
+{
+  STATE_ENTER(&HttpSM::tunnel_handler_splice, event);
+
+  ink_assert(event == NET_EVENT_SPLICE_DONE && data == splice_tunnel);
+
+  const NetSplice &up   = splice_tunnel->channel(SpliceTunnel::A_TO_B);
+  const NetSplice &down = splice_tunnel->channel(SpliceTunnel::B_TO_A);
+  client_request_body_bytes += up.bytes_read;
+  server_request_body_bytes += up.bytes_written;
+  server_response_body_bytes += down.bytes_read;
+  client_response_body_bytes += down.bytes_written;
+  SMDebug("http", "[%" PRId64 "] splice tunnel done, up: %" PRId64 " down: %" PRId64 " event: %d", sm_id, up.bytes_written,
+          down.bytes_written, splice_tunnel->error_event);
+
+  kill_splice_tunnel();
+
+  // Both connections are left to us, as HttpTunnel::close_vc() would do for a blind tunnel.
+  ua_entry->vc->do_io_close();
+  server_entry->vc->do_io_close();
+
+  return tunnel_handler(HTTP_TUNNEL_EVENT_DONE, nullptr);
+}
+
 /****************************************************
    TUNNELING HANDLERS
    ******************************************************/
@@ -4506,7 +4531,7 @@ HttpSM::do_cache_lookup_and_read()
           c_url->string_get(&t_state.arena));
 
   HttpCacheKey key;
-  Cache::generate_key(&key, c_url, t_state.txn_conf->cache_generation_number);
+  Cache::generate_key(&key, c_url, t_state.cache_info.key_hash, t_state.txn_conf->cache_generation_number);
 
   Action *cache_action_handle =
     cache_sm.open_read(&key, c_url, &t_state.hdr_info.client_request, t_state.txn_conf,
@@ -4538,7 +4563,7 @@ HttpSM::do_cache_delete_all_alts(Continuation *cont)
   Action *cache_action_handle = nullptr;
 
   HttpCacheKey key;
-  Cache::generate_key(&key, t_state.cache_info.lookup_url, t_state.txn_conf->cache_generation_number);
+  Cache::generate_key(&key, t_state.cache_info.lookup_url, t_state.cache_info.key_hash, t_state.txn_conf->cache_generation_number);
   cache_action_handle = cacheProcessor.remove(cont, &key);
   if (cont != nullptr) {
     if (cache_action_handle != ACTION_RESULT_DONE) {
@@ -4622,7 +4647,7 @@ HttpSM::do_cache_prepare_action(HttpCacheSM *c_sm, CacheHTTPInfo *object_read_in
   SMDebug("http_cache_write", "[%" PRId64 "] writing to cache with URL %s", sm_id, s_url->string_get(&t_state.arena));
 
   HttpCacheKey key;
-  Cache::generate_key(&key, s_url, t_state.txn_conf->cache_generation_number);
+  Cache::generate_key(&key, s_url, t_state.cache_info.key_hash, t_state.txn_conf->cache_generation_number);
 
   Action *cache_action_handle = c_sm->open_write(
     &key, s_url, &t_state.hdr_info.client_request, object_read_info,
@@ -6074,6 +6099,13 @@ HttpSM::setup_cache_read_transfer()
     doc_size += hdr_size;
   }
 
+  // Mapped fragments are only worth it when a plain HTTP/1 socket sends them with sendfile(), other
+  // clients would copy them anyway and touch the pages on a net thread while doing so.
+  if (!client_connection_is_ssl && !is_internal && ua_txn && ua_txn->is_chunked_encoding_supported() &&
+      dynamic_cast<UnixNetVConnection *>(ua_txn->get_netvc()) != nullptr) {
+    cache_sm.cache_read_vc->allow_mapped_fragments();
+  }
+
   HttpTunnelProducer *p = tunnel.add_producer(cache_sm.cache_read_vc, doc_size, buf_start, &HttpSM::tunnel_handler_cache_read,
                                               HT_CACHE_READ, "cache read");
   tunnel.add_consumer(ua_entry->vc, cache_sm.cache_read_vc, &HttpSM::tunnel_handler_ua, HT_HTTP_CLIENT, "user agent");
@@ -6677,6 +6709,10 @@ HttpSM::setup_blind_tunnel(bool send_response_hdr, IOBufferReader *initial)
   //  header buffer into new buffer
   client_request_body_bytes += from_ua_buf->write(ua_buffer_reader);
 
+  if (setup_splice_tunnel(from_ua_buf, r_from, to_ua_buf, r_to)) {
+    return;
+  }
+
   HTTP_SM_SET_DEFAULT_HANDLER(&HttpSM::tunnel_handler);
 
   p_os =
@@ -6706,6 +6742,50 @@ HttpSM::setup_blind_tunnel(bool send_response_hdr, IOBufferReader *initial)
   }
 }
 
+// Nothing looks at the bytes of a blind tunnel, so when both sockets allow it let the kernel move them
+// with splice(2) instead of copying them through the tunnel buffers. The buffers are still used to
+// send what was already read (the CONNECT response, a TLS client hello) ahead of the spliced data.
+bool
+HttpSM::setup_splice_tunnel(MIOBuffer *from_ua_buf, IOBufferReader *r_from, MIOBuffer *to_ua_buf, IOBufferReader *r_to)
+{
+  if (ua_txn == nullptr || server_session == nullptr || ua_txn->get_half_close_flag()) {
+    return false;
+  }
+
+  NetVConnection *ua_netvc = ua_txn->get_netvc();
+  NetVConnection *os_netvc = server_session->get_netvc();
+  if (!SpliceTunnel::can_splice(ua_netvc, os_netvc)) {
+    return false;
+  }
+
+  splice_tunnel = SpliceTunnel::start(this, ua_netvc, os_netvc, r_from, r_to);
+  if (splice_tunnel == nullptr) {
+    return false;
+  }
+  SMDebug("http", "[%" PRId64 "] blind tunnel using splice", sm_id);
+
+  splice_buffers[0] = from_ua_buf;
+  splice_buffers[1] = to_ua_buf;
+  HTTP_SM_SET_DEFAULT_HANDLER(&HttpSM::tunnel_handler_splice);
+
+  ua_entry->in_tunnel     = true;
+  server_entry->in_tunnel = true;
+  return true;
+}
+
+void
+HttpSM::kill_splice_tunnel()
+{
+  splice_tunnel->destroy();
+  splice_tunnel = nullptr;
+  for (MIOBuffer *&buf : splice_buffers) {
+    if (buf) {
+      free_MIOBuffer(buf);
+      buf = nullptr;
+    }
+  }
+}
+
 void
 HttpSM::setup_plugin_agents(HttpTunnelProducer *p)
 {
@@ -6784,6 +6864,16 @@ HttpSM::kill_this()
 
     cache_sm.end_both();
     transform_cache_sm.end_both();
+    if (splice_tunnel) {
+      // Going down hard with the splice tunnel still running, let the table close the connections.
+      kill_splice_tunnel();
+      if (ua_entry) {
+        ua_entry->in_tunnel = false;
+      }
+      if (server_entry) {
+        server_entry->in_tunnel = false;
+      }
+    }
     vc_table.cleanup_all();
 
     // tunnel.deallocate_buffers();
@@ -61,6 +61,7 @@ static size_t const HTTP_SERVER_RESP_HDR_BUFFER_INDEX = BUFFER_SIZE_INDEX_8K;
 
 class Http1ServerSession;
 class AuthHttpAdapter;
+class SpliceTunnel;
 
 class HttpSM;
 typedef int (HttpSM::*HttpSMHandler)(int event, void *data);
@@ -343,6 +344,10 @@ protected:
   int reentrancy_count = 0;
 
   HttpTunnel tunnel;
+  /// Replaces @c tunnel for blind tunnels that can be moved with splice(2).
+  SpliceTunnel *splice_tunnel = nullptr;
+  /// Buffers holding the bytes sent ahead of the spliced data, freed with @c splice_tunnel.
+  MIOBuffer *splice_buffers[2] = {nullptr, nullptr};
 
   HttpVCTable vc_table;
 
@@ -444,6 +449,7 @@ protected:
   int tunnel_handler_post_server(int event, HttpTunnelConsumer *c);
   int tunnel_handler_ssl_producer(int event, HttpTunnelProducer *p);
   int tunnel_handler_ssl_consumer(int event, HttpTunnelConsumer *p);
+  int tunnel_handler_splice(int event, void *data);
   int tunnel_handler_transform_write(int event, HttpTunnelConsumer *c);
   int tunnel_handler_transform_read(int event, HttpTunnelProducer *p);
   int tunnel_handler_plugin_agent(int event, HttpTunnelConsumer *c);
@@ -501,6 +507,8 @@ protected:
   void perform_transform_cache_write_action();
   void perform_nca_cache_action();
   void setup_blind_tunnel(bool send_response_hdr, IOBufferReader *initial = nullptr);
+  bool setup_splice_tunnel(MIOBuffer *from_ua_buf, IOBufferReader *r_from, MIOBuffer *to_ua_buf, IOBufferReader *r_to);
+  void kill_splice_tunnel();
   HttpTunnelProducer *setup_server_transfer_to_transform();
   HttpTunnelProducer *setup_transfer_from_transform();
   HttpTunnelProducer *setup_cache_transfer_to_transform();
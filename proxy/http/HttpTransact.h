@@ -512,6 +512,7 @@ public:
     URL *lookup_url = nullptr;
     URL lookup_url_storage;
     URL original_url;
+    URLHashCache key_hash; ///< Cache key hash of the last URL looked up or written
     HTTPInfo object_store;
     HTTPInfo transform_store;
     CacheDirectives directives;
@@ -23,6 +23,7 @@
 
 #include "HPACK.h"
 #include "HuffmanCodec.h"
+#include "tscore/HashFNV.h"
 
 // [RFC 7541] 4.1. Calculating Table Size
 // The size of an entry is the sum of its name's length in octets (as defined in Section 5.2),
@@ -166,6 +167,40 @@ static const StaticTable STATIC_TABLE[] = {{"", ""},
                                            {"via", ""},
                                            {"www-authenticate", ""}};
 
+// Hash indexes over STATIC_TABLE, mapping to the lowest index with the name or with the name and value.
+struct StaticTableIndex {
+  StaticTableIndex()
+  {
+    for (int index = TS_HPACK_STATIC_TABLE_ENTRY_NUM - 1; index > 0; --index) {
+      const StaticTable &entry = STATIC_TABLE[index];
+      const HpackLookupKey key(entry.name, entry.name_size, entry.value, entry.value_size);
+
+      name_index[key.name_hash]   = index;
+      field_index[key.field_hash] = index;
+    }
+  }
+
+  int
+  find(const HpackLookupKey &key, HpackMatch match) const
+  {
+    const auto &table = match == HpackMatch::EXACT ? field_index : name_index;
+    auto spot         = table.find(match == HpackMatch::EXACT ? key.field_hash : key.name_hash);
+
+    if (spot != table.end()) {
+      const StaticTable &entry = STATIC_TABLE[spot->second];
+      if (key.matches(entry.name, entry.name_size, entry.value, entry.value_size, match)) {
+        return spot->second;
+      }
+    }
+    return 0;
+  }
+
+  std::unordered_map<uint64_t, int> name_index;
+  std::unordered_map<uint64_t, int> field_index;
+};
+
+static const StaticTableIndex STATIC_TABLE_INDEX;
+
 /******************
  * Local functions
  ******************/
@@ -203,6 +238,67 @@ hpack_parse_field_type(uint8_t ftype)
   return HpackField::NOINDEX_LITERAL;
 }
 
+//
+// Choose field representation (See RFC7541 7.1.3)
+//
+static HpackField
+hpack_field_type(const MIMEFieldWrapper &header, const HpackIndexingTable &indexing_table)
+{
+  const int wks_idx = header.field_get()->m_wks_idx;
+  int name_len, value_len;
+  const char *name = header.name_get(&name_len);
+  header.value_get(&value_len);
+
+  // - Authorization headers obviously should not be indexed
+  // - Short Cookie header should not be indexed because of low entropy
+  if (wks_idx == MIME_WKSIDX_AUTHORIZATION || wks_idx == MIME_WKSIDX_PROXY_AUTHORIZATION ||
+      (wks_idx == MIME_WKSIDX_COOKIE && value_len < 20)) {
+    return HpackField::NEVERINDEX_LITERAL;
+  }
+
+  // - Values which are (nearly) unique per message would only push useful entries out of the dynamic table
+  if (wks_idx == MIME_WKSIDX_CONTENT_LENGTH || wks_idx == MIME_WKSIDX_AGE || wks_idx == MIME_WKSIDX_ETAG ||
+      wks_idx == MIME_WKSIDX_LAST_MODIFIED || wks_idx == MIME_WKSIDX_IF_MODIFIED_SINCE || wks_idx == MIME_WKSIDX_IF_NONE_MATCH ||
+      (name_len == 5 && memcmp(name, ":path", 5) == 0)) {
+    return HpackField::NOINDEX_LITERAL;
+  }
+
+  // - So would an entry taking up most of the dynamic table
+  if (ADDITIONAL_OCTETS + name_len + value_len > indexing_table.maximum_size() / 4 * 3) {
+    return HpackField::NOINDEX_LITERAL;
+  }
+
+  return HpackField::INDEXED_LITERAL;
+}
+
+/************************
+ * HpackLookupKey
+ ************************/
+HpackLookupKey::HpackLookupKey(const char *n, int n_len, const char *v, int v_len)
+  : name(n), name_len(n_len), value(v), value_len(v_len)
+{
+  ATSHash64FNV1a hash;
+
+  hash.update(name, name_len, ATSHash::nocase());
+  hash.final();
+  name_hash = hash.get();
+
+  hash.update(&name_len, sizeof(name_len));
+  hash.update(value, value_len);
+  hash.final();
+  field_hash = hash.get();
+}
+
+bool
+HpackLookupKey::matches(const char *table_name, int table_name_len, const char *table_value, int table_value_len,
+                        HpackMatch match) const
+{
+  if (ptr_len_casecmp(name, name_len, table_name, table_name_len) != 0) {
+    return false;
+  }
+  return match != HpackMatch::EXACT || (value_len == table_value_len && memcmp(value, table_value, value_len) == 0);
+}
+
 /************************
  * HpackIndexingTable
  ************************/
@@ -219,43 +315,23 @@ HpackLookupResult
 HpackIndexingTable::lookup(const char *name, int name_len, const char *value, int value_len) const
 {
   HpackLookupResult result;
-  const unsigned int entry_num = TS_HPACK_STATIC_TABLE_ENTRY_NUM + _dynamic_table->length();
-
-  for (unsigned int index = 1; index < entry_num; ++index) {
-    const char *table_name, *table_value;
-    int table_name_len = 0, table_value_len = 0;
-
-    if (index < TS_HPACK_STATIC_TABLE_ENTRY_NUM) {
-      // static table
-      table_name      = STATIC_TABLE[index].name;
-      table_value     = STATIC_TABLE[index].value;
-      table_name_len  = STATIC_TABLE[index].name_size;
-      table_value_len = STATIC_TABLE[index].value_size;
-    } else {
-      // dynamic table
-      const MIMEField *m_field = _dynamic_table->get_header_field(index - TS_HPACK_STATIC_TABLE_ENTRY_NUM);
-
-      table_name  = m_field->name_get(&table_name_len);
-      table_value = m_field->value_get(&table_value_len);
-    }
-
-    // Check whether name (and value) are matched
-    if (ptr_len_casecmp(name, name_len, table_name, table_name_len) == 0) {
-      if ((value_len == table_value_len) && (memcmp(value, table_value, value_len) == 0)) {
-        result.index      = index;
-        result.match_type = HpackMatch::EXACT;
-        break;
-      } else if (!result.index) {
-        result.index      = index;
-        result.match_type = HpackMatch::NAME;
-      }
-    }
-  }
-  if (result.match_type != HpackMatch::NONE) {
-    if (result.index < TS_HPACK_STATIC_TABLE_ENTRY_NUM) {
+  const HpackLookupKey key(name, name_len, value, value_len);
+  uint32_t index;
+
+  // The lowest index wins for each kind of match, so the static table is checked first, and an exact
+  // match is preferred over a name match wherever it is.
+  for (HpackMatch match : {HpackMatch::EXACT, HpackMatch::NAME}) {
+    if ((index = STATIC_TABLE_INDEX.find(key, match)) != 0) {
+      result.index      = index;
       result.index_type = HpackIndex::STATIC;
-    } else {
+      result.match_type = match;
+      break;
+    }
+    if (_dynamic_table->lookup(key, match, index)) {
+      result.index      = TS_HPACK_STATIC_TABLE_ENTRY_NUM + index;
       result.index_type = HpackIndex::DYNAMIC;
+      result.match_type = match;
+      break;
     }
   }
 
@@ -324,6 +400,25 @@ HpackDynamicTable::get_header_field(uint32_t index) const
   return this->_headers.at(this->_headers.size() - index - 1);
 }
 
+bool
+HpackDynamicTable::lookup(const HpackLookupKey &key, HpackMatch match, uint32_t &index) const
+{
+  const auto &table = match == HpackMatch::EXACT ? _field_index : _name_index;
+  auto spot         = table.find(match == HpackMatch::EXACT ? key.field_hash : key.name_hash);
+
+  if (spot == table.end()) {
+    return false;
+  }
+
+  index                  = _insert_count - 1 - spot->second;
+  const MIMEField *field = this->get_header_field(index);
+  int name_len, value_len;
+  const char *name  = field->name_get(&name_len);
+  const char *value = field->value_get(&value_len);
+
+  return key.matches(name, name_len, value, value_len, match);
+}
+
 void
 HpackDynamicTable::add_header_field(const MIMEField *field)
 {
@@ -340,6 +435,8 @@ HpackDynamicTable::add_header_field(const MIMEField *field)
     this->_headers.clear();
     this->_mhdr->fields_clear();
     this->_current_size = 0;
+    this->_name_index.clear();
+    this->_field_index.clear();
   } else {
     this->_current_size += header_size;
     this->_evict_overflowed_entries();
@@ -349,6 +446,11 @@ HpackDynamicTable::add_header_field(const MIMEField *field)
     this->_mhdr->field_attach(new_field);
     // XXX Because entire Vec instance is copied, Its too expensive!
     this->_headers.push_back(new_field);
+
+    const HpackLookupKey key(name, name_len, value, value_len);
+    this->_name_index[key.name_hash]   = this->_insert_count;
+    this->_field_index[key.field_hash] = this->_insert_count;
+    ++this->_insert_count;
   }
 }
 
@@ -399,6 +501,7 @@ HpackDynamicTable::_evict_overflowed_entries()
     h->value_get(&value_len);
 
     this->_current_size -= ADDITIONAL_OCTETS + name_len + value_len;
+    this->_index_erase(h, this->_insert_count - this->_headers.size() + count);
     this->_mhdr->field_delete(h, false);
     ++count;
 
@@ -416,6 +519,25 @@ HpackDynamicTable::_evict_overflowed_entries()
   return true;
 }
 
+void
+HpackDynamicTable::_index_erase(const MIMEField *field, uint64_t absolute_index)
+{
+  int name_len, value_len;
+  const char *name  = field->name_get(&name_len);
+  const char *value = field->value_get(&value_len);
+  const HpackLookupKey key(name, name_len, value, value_len);
+
+  // Leave the index alone if it already points to a newer entry
+  auto spot = this->_name_index.find(key.name_hash);
+  if (spot != this->_name_index.end() && spot->second == absolute_index) {
+    this->_name_index.erase(spot);
+  }
+  spot = this->_field_index.find(key.field_hash);
+  if (spot != this->_field_index.end() && spot->second == absolute_index) {
+    this->_field_index.erase(spot);
+  }
+}
+
 int64_t
 encode_indexed_header_field(uint8_t *buf_start, const uint8_t *buf_end, uint32_t index)
 {
@@ -825,21 +947,8 @@ hpack_encode_header_block(HpackIndexingTable &indexing_table, uint8_t *out_buf,
 
   MIMEFieldIter field_iter;
   for (MIMEField *field = hdr->iter_get_first(&field_iter); field != nullptr; field = hdr->iter_get_next(&field_iter)) {
-    HpackField field_type;
     MIMEFieldWrapper header(field, hdr->m_heap, hdr->m_http->m_fields_impl);
-    int name_len;
-    int value_len;
-    const char *name = header.name_get(&name_len);
-    header.value_get(&value_len);
-    // Choose field representation (See RFC7541 7.1.3)
-    // - Authorization header obviously should not be indexed
-    // - Short Cookie header should not be indexed because of low entropy
-    if ((ptr_len_casecmp(name, name_len, MIME_FIELD_COOKIE, MIME_LEN_COOKIE) == 0 && value_len < 20) ||
-        (ptr_len_casecmp(name, name_len, MIME_FIELD_AUTHORIZATION, MIME_LEN_AUTHORIZATION) == 0)) {
-      field_type = HpackField::NEVERINDEX_LITERAL;
-    } else {
-      field_type = HpackField::INDEXED_LITERAL;
-    }
+    const HpackField field_type    = hpack_field_type(header, indexing_table);
     const HpackLookupResult result = indexing_table.lookup(header);
     switch (result.match_type) {
     case HpackMatch::NONE:
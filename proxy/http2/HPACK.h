@@ -28,6 +28,7 @@
 #include "HTTP.h"
 #include "../hdrs/XPACK.h"
 
+#include <unordered_map>
 #include <vector>
 
 // It means that any header field can be compressed/decompressed by ATS
@@ -62,6 +63,21 @@ struct HpackLookupResult {
   HpackMatch match_type = HpackMatch::NONE;
 };
 
+// A header field to look up in IndexingTable, with the hashes the table indexes are keyed on
+struct HpackLookupKey {
+  HpackLookupKey(const char *n, int n_len, const char *v, int v_len);
+
+  // Whether this field matches a table entry by name (case insensitive) or by name and value
+  bool matches(const char *table_name, int table_name_len, const char *table_value, int table_value_len, HpackMatch match) const;
+
+  const char *name;
+  int name_len;
+  const char *value;
+  int value_len;
+  uint64_t name_hash;
+  uint64_t field_hash;
+};
+
 class MIMEFieldWrapper
 {
 public:
@@ -126,6 +142,7 @@ public:
 
   const MIMEField *get_header_field(uint32_t index) const;
   void add_header_field(const MIMEField *field);
+  bool lookup(const HpackLookupKey &key, HpackMatch match, uint32_t &index) const;
 
   uint32_t maximum_size() const;
   uint32_t size() const;
@@ -135,12 +152,20 @@ public:
 
 private:
   bool _evict_overflowed_entries();
+  void _index_erase(const MIMEField *field, uint64_t absolute_index);
 
   uint32_t _current_size;
   uint32_t _maximum_size;
 
   MIMEHdr *_mhdr;
   std::vector<MIMEField *> _headers;
+
+  // Entries are indexed by the number of entries added before them, so the indexes need no update when
+  // older entries are evicted. Only the newest entry for a hash is kept, which is the one with the lowest
+  // index. Hashes are verified against the entry, so a collision only costs a missed match.
+  uint64_t _insert_count = 0;
+  std::unordered_map<uint64_t, uint64_t> _name_index;
+  std::unordered_map<uint64_t, uint64_t> _field_index;
 };
 
 // [RFC 7541] 2.3. Indexing Table
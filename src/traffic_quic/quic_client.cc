@@ -23,6 +23,7 @@
 
 #include "quic_client.h"
 
+#include <atomic>
 #include <iostream>
 #include <fstream>
 #include <string_view>
@@ -36,6 +37,12 @@ using namespace std::literals;
 static constexpr std::string_view HQ_ALPN_PROTO_LIST("\5hq-20"sv);
 static constexpr std::string_view H3_ALPN_PROTO_LIST("\5h3-20"sv);
 
+// Load mode (--connections), the responses are only counted and the rate is printed once every
+// connection has finished its request.
+static ink_hrtime bench_start;
+static std::atomic<int> bench_done;
+static std::atomic<int64_t> bench_bytes;
+
 QUICClient::QUICClient(const QUICClientConfig *config) : Continuation(new_ProxyMutex()), _config(config)
 {
   SET_HANDLER(&QUICClient::start);
@@ -72,6 +79,16 @@ QUICClient::start(int, void *)
     alpn_protos = HQ_ALPN_PROTO_LIST;
   }
 
+  bench_start = Thread::get_hrtime();
+  for (int i = 0; i < this->_config->connections; ++i) {
+    this->_connect(alpn_protos);
+  }
+  return EVENT_CONT;
+}
+
+void
+QUICClient::_connect(std::string_view alpn_protos)
+{
   for (struct addrinfo *info = this->_remote_addr_info; info != nullptr; info = info->ai_next) {
     NetVCOptions opt;
     opt.ip_proto            = NetVCOptions::USE_UDP;
@@ -89,7 +106,6 @@ QUICClient::start(int, void *)
       break;
     }
   }
-  return EVENT_CONT;
 }
 
 // Similar to HttpSM::state_http_server_open(int event, void *data)
@@ -201,6 +217,11 @@ Http09ClientApp::main_event_handler(int event, Event *data)
   switch (event) {
   case VC_EVENT_READ_READY:
   case VC_EVENT_READ_COMPLETE: {
+    if (this->_config->connections > 1) {
+      this->_discard_response(stream_io);
+      break;
+    }
+
     std::streambuf *default_stream = nullptr;
     std::ofstream f_stream;
 
@@ -245,6 +266,28 @@ Http09ClientApp::main_event_handler(int event, Event *data)
   return EVENT_CONT;
 }
 
+void
+Http09ClientApp::_discard_response(QUICStreamIO *stream_io)
+{
+  uint8_t buf[8192];
+  int64_t nread;
+  while ((nread = stream_io->read(buf, sizeof(buf))) > 0) {
+    bench_bytes += nread;
+  }
+
+  if (!stream_io->is_read_done()) {
+    return;
+  }
+
+  this->_qc->close(QUICConnectionErrorUPtr(new QUICConnectionError(QUICTransErrorCode::NO_ERROR, "Done")));
+  if (++bench_done == this->_config->connections) {
+    double secs = static_cast<double>(Thread::get_hrtime() - bench_start) / HRTIME_SECOND;
+    int n       = this->_config->connections;
+    printf("%d connections, %" PRId64 " bytes in %.3f s: %.1f connections/s\n", n, bench_bytes.load(), secs, n / secs);
+    ::exit(0);
+  }
+}
+
 //
 // Http3ClientApp
 //
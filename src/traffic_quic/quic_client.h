@@ -42,6 +42,7 @@ struct QUICClientConfig {
   int close             = false;
   int http0_9           = true;
   int http3             = false;
+  int connections       = 1;
 };
 
 class RespHandler : public Continuation
@@ -68,6 +69,8 @@ public:
   int state_http_server_open(int event, void *data);
 
 private:
+  void _connect(std::string_view alpn_protos);
+
   const QUICClientConfig *_config    = nullptr;
   struct addrinfo *_remote_addr_info = nullptr;
   HttpSessionAccept::Options options;
@@ -83,6 +86,7 @@ public:
 
 private:
   void _do_http_request();
+  void _discard_response(QUICStreamIO *stream_io);
 
   const QUICClientConfig *_config = nullptr;
   const char *_filename           = nullptr;
@@ -65,6 +65,8 @@ main(int argc, const char **argv)
     {"close", 'c', "Enable connection close excercise", "F", &config.close, nullptr, nullptr},
     {"http0_9", '-', "Enable HTTP/0.9", "T", &config.http0_9, nullptr, nullptr},
     {"http3", '-', "Enable HTTP/3", "F", &config.http3, nullptr, nullptr},
+    {"connections", 'n', "Open N connections at once, discard the responses and report the rate (HTTP/0.9 only)", "I",
+     &config.connections, nullptr, nullptr},
 
     HELP_ARGUMENT_DESCRIPTION(),
     VERSION_ARGUMENT_DESCRIPTION(),
@@ -77,6 +79,10 @@ main(int argc, const char **argv)
   if (config.http3) {
     config.http0_9 = false;
   }
+  if (config.connections > 1 && !config.http0_9) {
+    fprintf(stderr, "--connections needs HTTP/0.9\n");
+    return 1;
+  }
 
   init_diags(config.debug_tags, nullptr);
   RecProcessInit(RECM_STAND_ALONE);
@@ -23,6 +23,7 @@
 
 #include <cstdio>
 #include <atomic>
+#include <mutex>
 #include <string_view>
 #include <tuple>
 #include <unordered_map>
@@ -987,6 +988,50 @@ FileImpl::fgets(char *buf, size_t length)
   return buf;
 }
 
+////////////////////////////////////////////////////////////////////
+//
+// INKEventPool
+//
+////////////////////////////////////////////////////////////////////
+
+/** A named group of event threads created by a plugin for blocking work.
+
+    Events scheduled on a pool carry the pool as their cookie and event_pool_dispatched() as their
+    dispatch hook, so the dispatch (or cancel) of the event can take it back off the pool's queue count.
+*/
+struct INKEventPool {
+  std::string name;
+  EventType etype     = ET_CALL;
+  int64_t queue_limit = 0; ///< Maximum pending events, 0 for no limit.
+  std::atomic<int64_t> queued{0};
+
+  int queued_stat    = -1;
+  int scheduled_stat = -1;
+  int rejected_stat  = -1;
+};
+
+// Event types the core registers after plugin.config is loaded (ET_OCSP, ET_UDP and ET_TASK), pools
+// must leave room for them.
+static constexpr int EVENT_TYPES_RESERVED_FOR_CORE = 3;
+
+// Pools by event type.
+static INKEventPool *event_pools[MAX_EVENT_TYPES];
+
+/// Account for @a pool losing a pending event, either because it was dispatched or canceled.
+static void
+event_pool_dequeue(INKEventPool *pool)
+{
+  pool->queued.fetch_sub(1, std::memory_order_relaxed);
+  TSStatIntDecrement(pool->queued_stat, 1);
+}
+
+/// Dispatch hook of the events scheduled by TSContScheduleOnEventPool().
+static void
+event_pool_dispatched(Event *e)
+{
+  event_pool_dequeue(static_cast<INKEventPool *>(e->cookie));
+}
+
 ////////////////////////////////////////////////////////////////////
 //
 // INKContInternal
@@ -4631,6 +4676,107 @@ TSContScheduleEveryOnThread(TSCont contp, TSHRTime every /* millisecs */, TSEven
   return action;
 }
 
+TSEventPool
+TSEventPoolCreate(const char *name, int nthreads, int64_t queue_limit)
+{
+  sdk_assert(sdk_sanity_check_null_ptr((void *)name) == TS_SUCCESS);
+
+  if (nthreads <= 0 || queue_limit < 0) {
+    Error("Unable to create event pool '%s', invalid thread count %d or queue limit %" PRId64, name, nthreads, queue_limit);
+    return nullptr;
+  }
+
+  // Pools are usually created from TSPluginInit but may be created at any time.
+  static std::mutex create_mutex;
+  std::lock_guard<std::mutex> lock(create_mutex);
+
+  for (INKEventPool *pool : event_pools) {
+    if (pool != nullptr && pool->name == name) {
+      return reinterpret_cast<TSEventPool>(pool);
+    }
+  }
+
+  // Each pool is an event type of its own, and the event system aborts once it runs out of them.
+  // ET_TASK is still ET_CALL while the core has event types left to register.
+  int reserved = ET_TASK == ET_CALL ? EVENT_TYPES_RESERVED_FOR_CORE : 0;
+  if (eventProcessor.n_thread_groups + reserved >= MAX_EVENT_TYPES) {
+    Error("Unable to create event pool '%s', all %d event types are in use", name, MAX_EVENT_TYPES);
+    return nullptr;
+  }
+  if (eventProcessor.n_ethreads + nthreads > MAX_EVENT_THREADS) {
+    Error("Unable to create event pool '%s', %d more threads exceed the limit of %d", name, nthreads, MAX_EVENT_THREADS);
+    return nullptr;
+  }
+
+  INKEventPool *pool = new INKEventPool;
+  std::string stat_prefix;
+  size_t stacksize;
+
+  pool->name        = name;
+  pool->queue_limit = queue_limit;
+  stat_prefix       = "proxy.process.plugin.event_pool.";
+  stat_prefix.append(name);
+
+  pool->queued_stat =
+    TSStatCreate((stat_prefix + ".queued").c_str(), TS_RECORDDATATYPE_INT, TS_STAT_NON_PERSISTENT, TS_STAT_SYNC_SUM);
+  pool->scheduled_stat =
+    TSStatCreate((stat_prefix + ".scheduled").c_str(), TS_RECORDDATATYPE_INT, TS_STAT_NON_PERSISTENT, TS_STAT_SYNC_COUNT);
+  pool->rejected_stat =
+    TSStatCreate((stat_prefix + ".rejected").c_str(), TS_RECORDDATATYPE_INT, TS_STAT_NON_PERSISTENT, TS_STAT_SYNC_COUNT);
+  if (pool->queued_stat == TS_ERROR || pool->scheduled_stat == TS_ERROR || pool->rejected_stat == TS_ERROR) {
+    Error("Unable to create the statistics for event pool '%s'", name);
+    delete pool;
+    return nullptr;
+  }
+
+  REC_ReadConfigInteger(stacksize, "proxy.config.thread.default.stacksize");
+  pool->etype = eventProcessor.spawn_event_threads(name, nthreads, stacksize);
+
+  event_pools[pool->etype] = pool;
+  Debug("plugin", "created event pool '%s' with %d threads, queue limit %" PRId64, name, nthreads, queue_limit);
+
+  return reinterpret_cast<TSEventPool>(pool);
+}
+
+TSAction
+TSContScheduleOnEventPool(TSCont contp, TSHRTime timeout, TSEventPool poolp)
+{
+  sdk_assert(sdk_sanity_check_iocore_structure(contp) == TS_SUCCESS);
+  sdk_assert(sdk_sanity_check_null_ptr((void *)poolp) == TS_SUCCESS);
+
+  FORCE_PLUGIN_SCOPED_MUTEX(contp);
+
+  INKContInternal *i = reinterpret_cast<INKContInternal *>(contp);
+  INKEventPool *pool = reinterpret_cast<INKEventPool *>(poolp);
+
+  int64_t queued = pool->queued.fetch_add(1, std::memory_order_relaxed);
+  if (pool->queue_limit > 0 && queued >= pool->queue_limit) {
+    pool->queued.fetch_sub(1, std::memory_order_relaxed);
+    TSStatIntIncrement(pool->rejected_stat, 1);
+    return nullptr;
+  }
+  TSStatIntIncrement(pool->queued_stat, 1);
+  TSStatIntIncrement(pool->scheduled_stat, 1);
+
+  if (ink_atomic_increment(static_cast<int *>(&i->m_event_count), 1) < 0) {
+    ink_assert(!"not reached");
+  }
+
+  // The hook has to be in place before the event is queued, so the event is built here rather than
+  // through EventProcessor::schedule_imm() / schedule_in().
+  Event *e          = eventAllocator.alloc();
+  e->callback_event = timeout == 0 ? EVENT_IMMEDIATE : EVENT_INTERVAL;
+  e->cookie         = pool;
+  e->dispatch_hook  = event_pool_dispatched;
+  e->init(i, timeout == 0 ? 0 : Thread::get_hrtime() + HRTIME_MSECONDS(timeout), 0);
+
+  TSAction action = reinterpret_cast<TSAction>(eventProcessor.schedule(e, pool->etype));
+
+  /* This is a hack. Should be handled in ink_types */
+  action = (TSAction)((uintptr_t)action | 0x1);
+  return action;
+}
+
 TSReturnCode
 TSContThreadAffinitySet(TSCont contp, TSEventThread ethread)
 {
@@ -5311,6 +5457,35 @@ TSHttpTxnCacheLookupUrlGet(TSHttpTxn txnp, TSMBuffer bufp, TSMLoc obj)
   return TS_ERROR;
 }
 
+TSReturnCode
+TSHttpTxnCacheKeyGet(TSHttpTxn txnp, TSCacheKey key)
+{
+  sdk_assert(sdk_sanity_check_txn(txnp) == TS_SUCCESS);
+  sdk_assert(sdk_sanity_check_cachekey(key) == TS_SUCCESS);
+
+  HttpSM *sm    = (HttpSM *)txnp;
+  CacheInfo *ci = (CacheInfo *)key;
+  URL *l_url    = sm->t_state.cache_info.lookup_url;
+
+  if (ci->magic != CACHE_INFO_MAGIC_ALIVE || !l_url || !l_url->valid()) {
+    return TS_ERROR;
+  }
+
+  HttpCacheKey http_key;
+  Cache::generate_key(&http_key, l_url, sm->t_state.cache_info.key_hash, sm->t_state.txn_conf->cache_generation_number);
+  ci->cache_key = http_key.hash;
+
+  ats_free(ci->hostname);
+  ci->hostname = nullptr;
+  ci->len      = 0;
+  if (http_key.hostname && http_key.hostlen > 0) {
+    ci->hostname = (char *)ats_malloc(http_key.hostlen);
+    memcpy(ci->hostname, http_key.hostname, http_key.hostlen);
+    ci->len = http_key.hostlen;
+  }
+  return TS_SUCCESS;
+}
+
 TSReturnCode
 TSHttpTxnCacheLookupUrlSet(TSHttpTxn txnp, TSMBuffer bufp, TSMLoc obj)
 {
@@ -6670,6 +6845,9 @@ TSActionCancel(TSAction actionp)
     a = (Action *)((uintptr_t)actionp - 1);
     i = (INKContInternal *)a->continuation;
     i->handle_event_count(EVENT_IMMEDIATE);
+    if (Event *e = static_cast<Event *>(a); e->dispatch_hook == event_pool_dispatched && !a->cancelled) {
+      event_pool_dequeue(static_cast<INKEventPool *>(e->cookie));
+    }
   } else {
     a = (Action *)actionp;
   }
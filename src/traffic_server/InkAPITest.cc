@@ -3017,6 +3017,111 @@ REGRESSION_TEST(SDK_API_TSContSchedule)(RegressionTest *test, int /* atype ATS_U
   TSContScheduleOnPool(contp2, 10, TS_THREAD_POOL_NET);
 }
 
+//////////////////////////////////////////////
+//       SDK_API_TSEventPool
+//
+// Unit Test for API: TSEventPoolCreate
+//                    TSContScheduleOnEventPool
+//////////////////////////////////////////////
+
+static RegressionTest *SDK_EventPool_test;
+static int *SDK_EventPool_pstatus;
+static TSEventPool SDK_EventPool_pool;
+
+static int
+event_pool_idle_handler(TSCont /* contp ATS_UNUSED */, TSEvent /* event ATS_UNUSED */, void * /* edata ATS_UNUSED */)
+{
+  return 0;
+}
+
+static int
+event_pool_handler(TSCont contp, TSEvent event, void * /* edata ATS_UNUSED */)
+{
+  // The event that got here is no longer pending, so the pool has room for two again.
+  TSCont idle     = TSContCreate(event_pool_idle_handler, TSMutexCreate());
+  TSAction first  = TSContScheduleOnEventPool(idle, 60000, SDK_EventPool_pool);
+  TSAction second = TSContScheduleOnEventPool(idle, 60000, SDK_EventPool_pool);
+
+  if (event == TS_EVENT_IMMEDIATE && first != nullptr && second != nullptr) {
+    SDK_RPRINT(SDK_EventPool_test, "TSContScheduleOnEventPool", "TestCase4", TC_PASS, "ok");
+    *SDK_EventPool_pstatus = REGRESSION_TEST_PASSED;
+  } else {
+    SDK_RPRINT(SDK_EventPool_test, "TSContScheduleOnEventPool", "TestCase4", TC_FAIL, "dispatched event still counted as pending");
+    *SDK_EventPool_pstatus = REGRESSION_TEST_FAILED;
+  }
+
+  if (first != nullptr) {
+    TSActionCancel(first);
+  }
+  if (second != nullptr) {
+    TSActionCancel(second);
+  }
+  TSContDestroy(idle);
+  TSContDestroy(contp);
+  return 0;
+}
+
+REGRESSION_TEST(SDK_API_TSEventPool)(RegressionTest *test, int /* atype ATS_UNUSED */, int *pstatus)
+{
+  *pstatus = REGRESSION_TEST_INPROGRESS;
+
+  SDK_EventPool_test    = test;
+  SDK_EventPool_pstatus = pstatus;
+
+  // Test Case 1: a pool is created once and found again by name
+  SDK_EventPool_pool = TSEventPoolCreate("regression_event_pool", 1, 2);
+  if (SDK_EventPool_pool == nullptr || TSEventPoolCreate("regression_event_pool", 1, 2) != SDK_EventPool_pool) {
+    SDK_RPRINT(test, "TSEventPoolCreate", "TestCase1", TC_FAIL, "pool not created or not shared");
+    *pstatus = REGRESSION_TEST_FAILED;
+    return;
+  }
+  SDK_RPRINT(test, "TSEventPoolCreate", "TestCase1", TC_PASS, "ok");
+
+  // Test Case 2: the queue limit counts pending events, and canceling one makes room again
+  TSCont idle     = TSContCreate(event_pool_idle_handler, TSMutexCreate());
+  TSAction first  = TSContScheduleOnEventPool(idle, 60000, SDK_EventPool_pool);
+  TSAction second = TSContScheduleOnEventPool(idle, 60000, SDK_EventPool_pool);
+  TSAction third  = TSContScheduleOnEventPool(idle, 60000, SDK_EventPool_pool);
+  bool limited    = first != nullptr && second != nullptr && third == nullptr;
+
+  if (second != nullptr) {
+    TSActionCancel(second);
+  }
+  second  = TSContScheduleOnEventPool(idle, 60000, SDK_EventPool_pool);
+  limited = limited && second != nullptr;
+  for (TSAction action : {first, second, third}) {
+    if (action != nullptr) {
+      TSActionCancel(action);
+    }
+  }
+  TSContDestroy(idle);
+  if (!limited) {
+    SDK_RPRINT(test, "TSContScheduleOnEventPool", "TestCase2", TC_FAIL, "queue limit not applied");
+    *pstatus = REGRESSION_TEST_FAILED;
+    return;
+  }
+  SDK_RPRINT(test, "TSContScheduleOnEventPool", "TestCase2", TC_PASS, "ok");
+
+  // Test Case 3: invalid arguments fail the creation without using up an event type or threads.
+  // The limit on event types itself is not exercised, that would leave every remaining type taken
+  // by pool threads for the rest of the regression run.
+  int groups  = eventProcessor.n_thread_groups;
+  int threads = eventProcessor.n_ethreads;
+  bool failed = TSEventPoolCreate("regression_event_pool_bad", 0, 0) == nullptr &&
+                TSEventPoolCreate("regression_event_pool_bad", 1, -1) == nullptr &&
+                TSEventPoolCreate("regression_event_pool_bad", MAX_EVENT_THREADS, 0) == nullptr;
+  if (!failed || eventProcessor.n_thread_groups != groups || eventProcessor.n_ethreads != threads) {
+    SDK_RPRINT(test, "TSEventPoolCreate", "TestCase3", TC_FAIL, "invalid pool created or resources used");
+    *pstatus = REGRESSION_TEST_FAILED;
+    return;
+  }
+  SDK_RPRINT(test, "TSEventPoolCreate", "TestCase3", TC_PASS, "ok");
+
+  // Test Case 4: a dispatched event is no longer pending, see event_pool_handler
+  TSCont contp = TSContCreate(event_pool_handler, TSMutexCreate());
+  TSContScheduleOnEventPool(contp, 0, SDK_EventPool_pool);
+}
+
 //////////////////////////////////////////////////////////////////////////////
 //     SDK_API_HttpHookAdd
 //
@@ -426,6 +426,8 @@ public:
       RecSetRecordInt("proxy.process.traffic_server.memory.rss", _usage.ru_maxrss << 10, REC_SOURCE_DEFAULT); // * 1024
       Debug("server", "memory usage - ru_maxrss: %ld memory limit: %" PRId64, _usage.ru_maxrss, _memory_limit);
       if (_memory_limit > 0) {
+        // ru_maxrss is a high water mark, use the current size for the keep-alive shedding pressure so it can recede.
+        net_memory_usage_pct = static_cast<int>(current_rss() * 100 / _memory_limit);
         if (_usage.ru_maxrss > _memory_limit) {
           if (net_memory_throttle == false) {
             net_memory_throttle = true;
@@ -439,6 +441,7 @@ public:
         }
       } else {
         // this feature has not been enabled
+        net_memory_usage_pct = 0;
         Debug("server", "limiting connections based on memory usage has been disabled");
         e->cancel();
         delete this;
@@ -449,6 +452,23 @@ public:
   }
 
 private:
+  /// Current resident set size in KB, falling back to the peak where the platform doesn't expose it.
+  int64_t
+  current_rss() const
+  {
+#if defined(linux)
+    if (FILE *fp = fopen("/proc/self/statm", "r"); fp != nullptr) {
+      long size = 0, resident = 0;
+      int n     = fscanf(fp, "%ld %ld", &size, &resident);
+      fclose(fp);
+      if (n == 2) {
+        return static_cast<int64_t>(resident) * (ats_pagesize() >> 10);
+      }
+    }
+#endif
+    return _usage.ru_maxrss;
+  }
+
   int64_t _memory_limit = 0;
   struct rusage _usage;
 };
@@ -1789,6 +1809,7 @@ main(int /* argc ATS_UNUSED */, const char **argv)
   }
 
   REC_ReadConfigInteger(thread_max_heartbeat_mseconds, "proxy.config.thread.max_heartbeat_mseconds");
+  REC_ReadConfigInteger(thread_handler_stall_mseconds, "proxy.config.thread.handler_stall_mseconds");
 
   ink_event_system_init(ts::ModuleVersion(1, 0, ts::ModuleVersion::PRIVATE));
   ink_net_init(ts::ModuleVersion(1, 0, ts::ModuleVersion::PRIVATE));
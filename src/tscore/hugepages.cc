@@ -40,7 +40,7 @@ size_t
 ats_hugepage_size()
 {
 #ifdef MAP_HUGETLB
-  return hugepage_size;
+  return hugepage_size > 0 ? hugepage_size : 0;
 #else
   Debug(DEBUG_TAG, "MAP_HUGETLB not defined");
   return 0;
@@ -67,11 +67,8 @@ ats_hugepage_init(int enabled)
 
   hugepage_size = 0;
 
-  if (!enabled) {
-    Debug(DEBUG_TAG "_init", "hugepages not enabled");
-    return;
-  }
-
+  // The size is detected even if explicit huge pages are not enabled, it is also used to size and
+  // align regions backed by transparent huge pages.
   fp = fopen(MEMINFO_PATH, "r");
 
   if (fp == nullptr) {
@@ -96,7 +93,9 @@ ats_hugepage_init(int enabled)
 
   fclose(fp);
 
-  if (hugepage_size) {
+  if (!enabled) {
+    Debug(DEBUG_TAG "_init", "hugepages not enabled");
+  } else if (hugepage_size) {
     hugepage_enabled = true;
   }
 
@@ -146,3 +145,31 @@ ats_free_hugepage(void *ptr, size_t s)
   return false;
 #endif
 }
+
+void *
+ats_alloc_transparent_hugepage(size_t s)
+{
+#if defined(MAP_HUGETLB) && defined(MADV_HUGEPAGE)
+  if (hugepage_size <= 0) {
+    return nullptr;
+  }
+
+  size_t size = INK_ALIGN(s, ats_hugepage_size());
+  void *mem   = nullptr;
+
+  if (posix_memalign(&mem, ats_hugepage_size(), size) != 0) {
+    Debug(DEBUG_TAG, "Could not allocate aligned region size = %zu", size);
+    return nullptr;
+  }
+  if (madvise(mem, size, MADV_HUGEPAGE) != 0) {
+    Debug(DEBUG_TAG, "MADV_HUGEPAGE failed for {%p} size = %zu", mem, size);
+  }
+
+  Debug(DEBUG_TAG, "Transparent Request/Allocation (%zu/%zu) {%p}", s, size, mem);
+  return mem;
+#else
+  (void)s;
+  Debug(DEBUG_TAG, "MADV_HUGEPAGE not defined");
+  return nullptr;
+#endif
+}
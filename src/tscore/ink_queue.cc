@@ -164,6 +164,21 @@ ink_freelist_madvise_init(InkFreeList **fl, const char *name, uint32_t type_size
   (*fl)->advice = advice;
 }
 
+void
+ink_freelist_hugepage_init(InkFreeList **fl, const char *name, uint32_t type_size, uint32_t chunk_size, uint32_t alignment,
+                           int advice)
+{
+  ink_freelist_madvise_init(fl, name, type_size, chunk_size, alignment, advice);
+
+  InkFreeList *f = *fl;
+  f->hugepages   = 1;
+  // Carve whole huge pages, so every chunk is backed entirely by huge pages.
+  if (ats_hugepage_size() > 0) {
+    f->chunk_size = INK_ALIGN(f->chunk_size * f->type_size, ats_hugepage_size()) / f->type_size;
+  }
+  Debug(DEBUG_TAG "_init", "<%s> Huge page chunk size (%" PRIu32 ")", name, f->chunk_size);
+}
+
 InkFreeList *
 ink_freelist_create(const char *name, uint32_t type_size, uint32_t chunk_size, uint32_t alignment)
 {
@@ -209,6 +224,18 @@ freelist_new(InkFreeList *f)
       if (ats_hugepage_enabled()) {
         alignment = ats_hugepage_size();
         newp      = ats_alloc_hugepage(alloc_size);
+        if (newp) {
+          ink_atomic_increment((int *)&f->hugepage_allocated, f->chunk_size);
+        }
+      }
+
+      // No reserved huge pages, fall back to transparent huge pages.
+      if (newp == nullptr && f->hugepages) {
+        alignment = ats_hugepage_size();
+        newp      = ats_alloc_transparent_hugepage(alloc_size);
+        if (newp) {
+          ink_atomic_increment((int *)&f->transparent_allocated, f->chunk_size);
+        }
       }
 
       if (newp == nullptr) {